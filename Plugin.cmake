@@ -60,9 +60,13 @@ set(GENERAL_HEADERS
     include/GuardZone.h
     include/GuardZoneBogey.h
     include/Kalman.h
+    include/LatencyHistogram.h
     include/Matrix.h
     include/MessageBox.h
     include/OptionsDialog.h
+    include/PacketCapture.h
+    include/PacketRecorder.h
+    include/PolarToCartesianLookup.h
 #    include/RadarCanvas.h
     include/RadarControl.h
     include/RadarControlItem.h
@@ -72,14 +76,24 @@ set(GENERAL_HEADERS
     include/RadarFactory.h
 #    include/RadarInfo.h
     include/RadarLocationInfo.h
+    include/RadarProcess.h
     include/Arpa.h
 #    include/RadarPanel.h
     include/RadarReceive.h
     include/RadarType.h
+    include/ReplayReceive.h
     include/SelectDialog.h
     include/SoftwareControlSet.h
+    include/SpokePreprocess.h
+    include/SpokeQueue.h
+    include/SpokeResample.h
+    include/SpokeWorkers.h
     include/TextureFont.h
+    include/TrailAge.h
     include/TrailBuffer.h
+    include/TrailSpoke.h
+    include/TrailTiles.h
+    include/VertexArena.h
     include/drawutil.h
     include/icons.h
     include/pi_common.h
@@ -95,8 +109,12 @@ set(GENERAL_SOURCES
     src/GuardZone.cpp
     src/GuardZoneBogey.cpp
     src/Kalman.cpp
+    src/LatencyHistogram.cpp
     src/MessageBox.cpp
     src/OptionsDialog.cpp
+    src/PacketCapture.cpp
+    src/PacketRecorder.cpp
+    src/PolarToCartesianLookup.cpp
 #    src/RadarCanvas.cpp
     src/RadarDraw.cpp
     src/RadarDrawShader.cpp
@@ -104,10 +122,18 @@ set(GENERAL_SOURCES
     src/RadarFactory.cpp
 #    src/RadarInfo.cpp
     src/Arpa.cpp
+    src/RadarProcess.cpp
 #    src/RadarPanel.cpp
     src/SelectDialog.cpp
+    src/SpokePreprocess.cpp
+    src/SpokeQueue.cpp
+    src/SpokeResample.cpp
+    src/SpokeWorkers.cpp
     src/TextureFont.cpp
     src/TrailBuffer.cpp
+    src/TrailSpoke.cpp
+    src/TrailTiles.cpp
+    src/VertexArena.cpp
     src/drawutil.cpp
     src/icons.cpp
 #    src/radar_pi.cpp
@@ -172,6 +198,7 @@ set(NAVICO_HEADERS
     include/navico/NavicoControl.h
     include/navico/NavicoControlSet.h
     include/navico/NavicoControlsDialog.h
+    include/navico/NavicoExpand.h
     include/navico/NavicoLocate.h
     include/navico/NavicoReceive.h
     include/navico/br24type.h
@@ -184,6 +211,7 @@ set(NAVICO_HEADERS
 set(NAVICO_SOURCES
     src/navico/NavicoControl.cpp
     src/navico/NavicoControlsDialog.cpp
+    src/navico/NavicoExpand.cpp
     src/navico/NavicoLocate.cpp
     src/navico/NavicoReceive.cpp
 )
@@ -195,6 +223,7 @@ set(RAYMARINE_HEADERS
     include/raymarine/RME120ControlSet.h
     include/raymarine/RME120ControlsDialog.h
     include/raymarine/RaymarineReceive.h
+    include/raymarine/RaymarineUnpack.h
     include/raymarine/RME120type.h
     include/raymarine/RMQuantumtype.h
     include/raymarine/RaymarineCommon.h
@@ -207,6 +236,7 @@ set(RAYMARINE_SOURCES
     src/raymarine/RMQuantumControl.cpp
     src/raymarine/RME120ControlsDialog.cpp
     src/raymarine/RaymarineReceive.cpp
+    src/raymarine/RaymarineUnpack.cpp
     src/raymarine/RaymarineLocate.cpp
     src/raymarine/RMQuantumControlsDialog.cpp
 )
@@ -0,0 +1,55 @@
+# ~~~
+# Summary:      Headless spoke pipeline and control item benchmarks
+# License:      GPLv2+
+# ~~~
+
+# radar-spoke-bench links all plugin sources into a standalone executable,
+# compiled with RADAR_BENCH so that radar_pi does not derive from the OpenCPN
+# plugin classes. The OpenCPN API functions that the plugin calls are stubbed
+# in src/bench/OpenCPNStubs.cpp, so a new API call is a link error here until
+# it gets a stub. Counting allocations needs the GNU linker.
+#
+#   cmake -DRADAR_BENCHMARK=ON ..
+#   make radar-spoke-bench && ./radar-spoke-bench [revolutions]
+
+option(RADAR_BENCHMARK "Build the headless spoke pipeline benchmark" OFF)
+if(NOT RADAR_BENCHMARK)
+  return()
+endif()
+if(NOT UNIX OR APPLE)
+  message(WARNING "radar-spoke-bench is only supported on Linux")
+  return()
+endif()
+
+add_executable(
+  radar-spoke-bench EXCLUDE_FROM_ALL src/bench/OpenCPNStubs.cpp
+                    src/bench/SpokeBench.cpp ${SRC})
+target_compile_definitions(
+  radar-spoke-bench
+  PRIVATE RADAR_BENCH $<TARGET_PROPERTY:${PACKAGE_NAME},COMPILE_DEFINITIONS>)
+target_include_directories(
+  radar-spoke-bench
+  PRIVATE $<TARGET_PROPERTY:${PACKAGE_NAME},INCLUDE_DIRECTORIES>)
+target_link_libraries(radar-spoke-bench
+                      $<TARGET_PROPERTY:${PACKAGE_NAME},LINK_LIBRARIES>)
+set_target_properties(
+  radar-spoke-bench
+  PROPERTIES POSITION_INDEPENDENT_CODE OFF
+             LINK_FLAGS
+             "-no-pie -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc"
+)
+
+# radar-control-bench only needs RadarControlItem.h and wxWidgets.
+#
+#   make radar-control-bench && ./radar-control-bench [spokes]
+
+add_executable(radar-control-bench EXCLUDE_FROM_ALL
+                                   src/bench/ControlItemBench.cpp)
+target_compile_definitions(
+  radar-control-bench
+  PRIVATE $<TARGET_PROPERTY:${PACKAGE_NAME},COMPILE_DEFINITIONS>)
+target_include_directories(
+  radar-control-bench
+  PRIVATE $<TARGET_PROPERTY:${PACKAGE_NAME},INCLUDE_DIRECTORIES>)
+target_link_libraries(radar-control-bench
+                      $<TARGET_PROPERTY:${PACKAGE_NAME},LINK_LIBRARIES>)
@@ -162,6 +162,7 @@ public:
         DeleteAllTargets(); // Let ARPA targets disappear
     }
     void ClearContours();
+    void ZoomContours(double zoom);
     int GetTargetCount() { return m_number_of_targets; }
 
 private:
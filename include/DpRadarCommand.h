@@ -58,6 +58,7 @@ private:
     void initActions();
 
     void SendToDp(RadarInfo* ri, std::initializer_list<std::pair<const wxString, wxVariant>> values);
+    void SendToDp(RadarInfo* ri, wxJSONValue& root);
 
     std::unordered_map<wxString, std::function<void(RadarInfo*, const wxJSONValue&)>> m_actions;
 
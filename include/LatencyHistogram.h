@@ -0,0 +1,191 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _LATENCYHISTOGRAM_H_
+#define _LATENCYHISTOGRAM_H_
+
+#include <atomic>
+#include <chrono>
+
+#include "pi_common.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// Latency histograms for the stages that every spoke goes through.
+//
+// The buckets are log-linear like HdrHistogram: each power of two is split
+// in 2^LATENCY_SUB_BITS linear buckets, so any value is known to within
+// 12.5%. Recording is a single relaxed atomic increment, so the receive and
+// process threads can record while the GUI thread reads. When disabled the
+// timers do not even read the clock.
+//
+
+enum LatencyStage {
+    LATENCY_DECODE, // *Receive::ProcessFrame, per packet
+    LATENCY_SPOKE, // All of RadarInfo::ProcessRadarSpoke
+    LATENCY_PREPROCESS, // Main bang, threshold and m_history
+    LATENCY_GUARD_ZONE,
+    LATENCY_TRUE_TRAILS,
+    LATENCY_RELATIVE_TRAILS,
+    LATENCY_COLOUR_SPOKE, // ColourSpoke, once for both draws
+    LATENCY_DRAW_OVERLAY,
+    LATENCY_DRAW_PANEL,
+    LATENCY_TEXTURE_UPLOAD, // Shader spokes to the GPU, per draw
+    LATENCY_STAGES
+};
+
+#define LATENCY_SUB_BITS (3)
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS)
+
+class LatencyHistogram {
+public:
+    LatencyHistogram() { Reset(); }
+
+    void Record(uint64_t nanos)
+    {
+        m_buckets[Bucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (nanos > max
+            && !m_max.compare_exchange_weak(
+                max, nanos, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Reset();
+    uint64_t GetCount();
+    uint64_t GetMax() { return m_max.load(std::memory_order_relaxed); }
+
+    // Value (in ns) below which `percentile` percent of the samples are
+    uint64_t GetPercentile(double percentile);
+
+private:
+    static size_t Bucket(uint64_t nanos)
+    {
+        if (nanos < (1 << LATENCY_SUB_BITS)) {
+            return (size_t)nanos;
+        }
+        int msb = HighestBit(nanos);
+        int shift = msb - LATENCY_SUB_BITS;
+        return ((size_t)(shift + 1) << LATENCY_SUB_BITS)
+            + (size_t)((nanos >> shift) & ((1 << LATENCY_SUB_BITS) - 1));
+    }
+    static uint64_t BucketLimit(size_t bucket); // highest value in bucket
+
+    // Index of the highest bit that is set, `value` must not be 0
+    static int HighestBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+#if defined(_WIN64)
+        _BitScanReverse64(&index, value);
+        return (int)index;
+#else
+        if (_BitScanReverse(&index, (unsigned long)(value >> 32))) {
+            return (int)index + 32;
+        }
+        _BitScanReverse(&index, (unsigned long)value);
+        return (int)index;
+#endif
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    std::atomic<uint64_t> m_buckets[LATENCY_BUCKETS];
+    std::atomic<uint64_t> m_max;
+};
+
+class LatencyStats {
+public:
+    LatencyStats() { m_enabled = false; }
+
+    bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+    void Enable(bool enable); // Enabling starts with empty histograms
+    void Reset();
+
+    void Record(LatencyStage stage, uint64_t nanos)
+    {
+        m_stage[stage].Record(nanos);
+    }
+    LatencyHistogram& GetStage(LatencyStage stage) { return m_stage[stage]; }
+
+    // One line per stage that has samples: "name p50/p99/max us"
+    wxString GetText();
+
+    static const char* GetStageName(LatencyStage stage);
+
+    static uint64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+private:
+    std::atomic<bool> m_enabled;
+    LatencyHistogram m_stage[LATENCY_STAGES];
+};
+
+// Times from construction until Stop() or destruction, if enabled
+class LatencyTimer {
+public:
+    LatencyTimer(LatencyStats& stats, LatencyStage stage)
+        : m_stats(stats)
+        , m_stage(stage)
+    {
+        m_running = stats.IsEnabled();
+        m_start = m_running ? LatencyStats::Now() : 0;
+    }
+    ~LatencyTimer() { Stop(); }
+
+    void Stop()
+    {
+        if (m_running) {
+            m_stats.Record(m_stage, LatencyStats::Now() - m_start);
+            m_running = false;
+        }
+    }
+
+private:
+    LatencyStats& m_stats;
+    LatencyStage m_stage;
+    bool m_running;
+    uint64_t m_start;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _LATENCYHISTOGRAM_H_ */
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _PACKETCAPTURE_H_
+#define _PACKETCAPTURE_H_
+
+#include <atomic>
+
+#include "radar_pi.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// Flight recorder for the last N packets received from a radar.
+//
+// The receive thread copies each packet into the next slot, overwriting the
+// oldest one; nothing is formatted until somebody asks for a Dump(). Each slot
+// is guarded by a sequence number (odd while it is being written) so the
+// reader can skip a slot that is overwritten while it copies it, and neither
+// side ever takes a lock.
+//
+
+#define PACKET_CAPTURE_MAX_LEN (4096) // Longer packets are truncated
+
+class PacketCapture {
+public:
+    PacketCapture(radar_pi* pi, size_t packets);
+    ~PacketCapture();
+
+    // Receive thread only
+    void Capture(const uint8_t* data, size_t len);
+
+    // Log the captured packets, oldest first, and return how many there were.
+    // May be called from any thread.
+    size_t Dump(const wxString& what);
+
+    size_t GetCapacity() { return m_capacity; }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        uint32_t len; // as received, may be more than PACKET_CAPTURE_MAX_LEN
+        wxLongLong millis;
+        uint8_t data[PACKET_CAPTURE_MAX_LEN];
+    };
+
+    radar_pi* m_pi;
+    size_t m_capacity;
+    size_t m_mask;
+    Slot* m_slots;
+    std::atomic<size_t> m_head; // Total number of packets captured
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _PACKETCAPTURE_H_ */
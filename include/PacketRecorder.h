@@ -0,0 +1,182 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _PACKETRECORDER_H_
+#define _PACKETRECORDER_H_
+
+#include "radar_pi.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+class RadarReceive;
+
+//
+// Recording and replay of the raw datagrams that a radar sends.
+//
+// A recording consists of two append-only files:
+//
+// <name>      PacketFileHeader followed by one PacketRecordHeader + payload per
+//             datagram, each record padded to 8 bytes. This file is memory
+//             mapped and grown in RECORD_CHUNK steps.
+// <name>.idx  One PacketIndexEntry per datagram, so that the replay does not
+//             have to walk the data file. If it is missing or shorter than the
+//             data file (the plugin crashed while recording) the replay
+//             rebuilds it in memory.
+//
+// Recording to a file that already exists, for instance because the radar
+// was started again, continues that recording and writes its index again.
+//
+// Selecting a replay file in the ini file makes RadarFactory return a
+// ReplayReceive, which feeds the packets to the normal radar decoder.
+//
+
+enum PacketChannel {
+    PACKET_DATA, // Spoke data, as received on the data socket
+    PACKET_REPORT // Reports, as received on the report socket
+};
+
+#define PACKET_FILE_MAGIC "RADARPKT"
+#define PACKET_FILE_VERSION (1)
+
+#pragma pack(push, 1)
+
+struct PacketFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t radar_type;
+    uint64_t start_millis;
+    uint8_t reserved[40];
+}; // 64 bytes
+
+struct PacketRecordHeader {
+    uint64_t millis;
+    uint32_t len;
+    uint16_t channel;
+    uint16_t reserved;
+}; // 16 bytes
+
+struct PacketIndexEntry {
+    uint64_t offset; // of the PacketRecordHeader in the data file
+    uint64_t millis;
+};
+
+#pragma pack(pop)
+
+#define PACKET_RECORD_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+//
+// A file mapped into memory, either read-only or read-write and growable.
+//
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Create(const wxString& path, size_t size);
+    bool Open(const wxString& path);
+    bool OpenWritable(const wxString& path); // existing file, not truncated
+    bool Resize(size_t size);
+    void Close(size_t final_size);
+
+    uint8_t* GetData() { return m_data; }
+    size_t GetSize() { return m_size; }
+
+private:
+    bool OpenExisting();
+    bool Map();
+    void Unmap();
+
+#ifdef __WXMSW__
+    HANDLE m_file;
+    HANDLE m_mapping;
+#else
+    int m_fd;
+#endif
+    uint8_t* m_data;
+    size_t m_size;
+    bool m_writable;
+};
+
+class PacketRecorder {
+public:
+    PacketRecorder();
+    ~PacketRecorder();
+
+    bool Open(const wxString& path, RadarType radar_type);
+    void Close();
+
+    // Called from the receive thread for every datagram.
+    void Record(PacketChannel channel, const uint8_t* data, size_t len);
+
+    size_t GetPackets() { return m_packets; }
+
+private:
+    static const size_t RECORD_CHUNK = 16 * 1024 * 1024;
+
+    bool Continue(RadarType radar_type);
+
+    MappedFile m_file;
+    FILE* m_index;
+    wxString m_path;
+    size_t m_used; // bytes written to m_file
+    size_t m_packets;
+    bool m_failed;
+};
+
+class PacketReplay {
+public:
+    PacketReplay();
+    ~PacketReplay();
+
+    bool Open(const wxString& path, RadarType radar_type);
+
+    size_t GetPackets() { return m_packet_count; }
+
+    // Feed all packets to receiver->ReplayPacket(), either paced to the recorded
+    // timestamps or as fast as the process thread can take the spokes. Loops
+    // around at the end of the recording until *shutdown becomes true.
+    void Play(RadarReceive* receiver, RadarInfo* ri, bool realtime,
+        volatile bool* shutdown);
+
+private:
+    bool LoadIndex(const wxString& path);
+    void BuildIndex();
+
+    MappedFile m_file;
+    MappedFile m_index_file;
+    const PacketIndexEntry* m_index; // either in m_index_file or m_built_index
+    vector<PacketIndexEntry> m_built_index;
+    size_t m_packet_count;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _PACKETRECORDER_H_ */
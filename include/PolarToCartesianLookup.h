@@ -0,0 +1,116 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _POLAR_TO_CARTESIAN_LOOKUP_H_
+#define _POLAR_TO_CARTESIAN_LOOKUP_H_
+
+#include "drawutil.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// The x and y of every (spoke, radius), for converting spokes to pixels and
+// vertices. There is one lookup per geometry (spokes, spoke_len) in the
+// process; radars with the same geometry share it, see Get() and Release().
+//
+// When the number of spokes is a multiple of 8 only the first octant, spokes
+// 0 .. spokes / 8, is stored. The other spokes read the same row with x and
+// y swapped and/or negated, which is exact, so for a 2048 x 1024 radar the
+// table is 2 MB instead of 25 MB. Other spoke counts store every spoke.
+// PointInt is the float point truncated to int16_t, as it always was.
+//
+
+class PolarToCartesianLookup {
+public:
+    // The lookup for this geometry, shared by all radars that have it
+    static PolarToCartesianLookup* Get(size_t spokes, size_t spoke_len);
+    // Drops a reference, the last one deletes it
+    static void Release(PolarToCartesianLookup* lookup);
+
+    Point GetPoint(size_t angle, size_t radius)
+    {
+        const SpokeMap& m = m_map[WrapAngle(angle)];
+        const float* xy = &m_xy[(m.row + radius) * 2];
+        Point p;
+
+        p.x = m.sign_x * xy[m.x];
+        p.y = m.sign_y * xy[1 - m.x];
+        return p;
+    }
+    PointInt GetPointInt(size_t angle, size_t radius)
+    {
+        Point p = GetPoint(angle, radius);
+        PointInt pi;
+
+        pi.x = (int16_t)p.x;
+        pi.y = (int16_t)p.y;
+        return pi;
+    }
+
+    size_t GetMemoryUsed();
+    int GetUsers() { return m_users; }
+
+private:
+    PolarToCartesianLookup(size_t spokes, size_t spoke_len);
+    ~PolarToCartesianLookup();
+
+    // Where spoke a is stored: its row in m_xy, which element of the stored
+    // pair is x (the other one is y) and the signs of x and y.
+    struct SpokeMap {
+        uint32_t row;
+        uint32_t x;
+        float sign_x;
+        float sign_y;
+    };
+
+    // angle may be up to one revolution below 0, as an unsigned value
+    size_t WrapAngle(size_t angle)
+    {
+        if (m_spoke_mask) {
+            return (angle + m_spokes) & m_spoke_mask;
+        }
+        return (angle + m_spokes) % m_spokes;
+    }
+
+    size_t m_spokes;
+    size_t m_spoke_mask; // m_spokes - 1 if that is a power of two, else 0
+    size_t m_spoke_len;
+    size_t m_rows; // spokes stored in m_xy
+    float* m_xy; // m_rows * m_spoke_len pairs of cos, sin times radius
+    SpokeMap* m_map; // m_spokes
+
+    int m_users;
+    PolarToCartesianLookup* m_next; // in the list of all lookups
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif
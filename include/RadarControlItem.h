@@ -32,6 +32,8 @@
 #ifndef _RADAR_CONTROL_ITEM_H_
 #define _RADAR_CONTROL_ITEM_H_
 
+#include <atomic>
+
 #include "pi_common.h"
 
 PLUGIN_BEGIN_NAMESPACE
@@ -44,6 +46,11 @@ class radar_pi;
 //
 // Some controls are always only just a value.
 // Some other controls have state as well.
+//
+// Value and state are packed in one atomic word, so GetValue() and
+// GetState() never lock; the spoke processing reads several controls for
+// every spoke. Writers and the button/modified bookkeeping used by the
+// ControlsDialog take m_exclusive, which readers never touch.
 
 enum RadarControlState {
     RCS_OFF = -1,
@@ -65,8 +72,7 @@ public:
 
     RadarControlItem()
     {
-        m_value = 0;
-        m_state = RCS_OFF;
+        Store(0, RCS_OFF);
         m_button_v = VALUE_NOT_SET; // Unlikely value so that first actual set
                                     // sets proper value + mod
         m_button_s = RCS_OFF;
@@ -79,14 +85,22 @@ public:
     // The copy constructor
     RadarControlItem(const RadarControlItem& other)
     {
-        Update(other.m_value, other.m_state);
+        m_button_v = VALUE_NOT_SET;
+        m_button_s = RCS_OFF;
+        m_mod = true;
+        m_min = VALUE_NOT_SET;
+        m_max = VALUE_NOT_SET;
+        m_fraction = 0;
+        uint64_t word = other.m_word.load(std::memory_order_acquire);
+        Update(WordValue(word), WordState(word));
     }
 
     // The assignment constructor
     RadarControlItem& operator=(const RadarControlItem& other)
     {
         if (this != &other) { // self-assignment check expected
-            Update(other.m_value, other.m_state);
+            uint64_t word = other.m_word.load(std::memory_order_acquire);
+            Update(WordValue(word), WordState(word));
         }
         return *this;
     }
@@ -106,8 +120,7 @@ public:
             m_button_v = v;
             m_button_s = s;
         }
-        m_value = v;
-        m_state = s;
+        Store(v, s);
     };
 
     void UpdateState(RadarControlState s)
@@ -118,7 +131,7 @@ public:
             m_mod = true;
             m_button_s = s;
         }
-        m_state = s;
+        Store(GetValue(), s);
     };
 
     void Update(int v) { Update(v, RCS_MANUAL); };
@@ -160,16 +173,21 @@ public:
 
     int GetValue()
     {
-        wxCriticalSectionLocker lock(m_exclusive);
-
-        return m_value;
+        return WordValue(m_word.load(std::memory_order_acquire));
     }
 
     RadarControlState GetState()
     {
-        wxCriticalSectionLocker lock(m_exclusive);
+        return WordState(m_word.load(std::memory_order_acquire));
+    }
+
+    // Both, consistent with each other
+    int GetValue(RadarControlState* state)
+    {
+        uint64_t word = m_word.load(std::memory_order_acquire);
 
-        return m_state;
+        *state = WordState(word);
+        return WordValue(word);
     }
 
     bool IsModified()
@@ -194,7 +212,7 @@ public:
         }
         double new_value = (double)((x - m_min) * 100.) / (m_max - m_min) + .5;
         Update((int)new_value);
-        m_fraction = new_value - (double)m_value;
+        m_fraction = new_value - (double)GetValue();
         // wxLogMessage(wxT("new_value=%f, m_value=%i, m_fraction=%f"),
         // new_value, m_value, m_fraction);
     }
@@ -203,7 +221,7 @@ public:
     { // Reverse transform, transforms value to value to be transmitted to radar
         if (m_max == VALUE_NOT_SET || m_min == VALUE_NOT_SET
             || m_max == m_min) {
-            return m_value;
+            return GetValue();
         }
         return (
             int)(((double)(value) + m_fraction - .5) * (m_max - m_min) / 100.
@@ -211,10 +229,21 @@ public:
     }
 
 protected:
-    wxCriticalSection m_exclusive;
-    int m_value;
+    static int WordValue(uint64_t word) { return (int)(uint32_t)(word >> 32); }
+    static RadarControlState WordState(uint64_t word)
+    {
+        return (RadarControlState)(int32_t)(uint32_t)word;
+    }
+    void Store(int v, RadarControlState s)
+    {
+        m_word.store(((uint64_t)(uint32_t)v << 32) | (uint32_t)(int32_t)s,
+            std::memory_order_release);
+    }
+
+    std::atomic<uint64_t> m_word; // value << 32 | state, read without lock
+
+    wxCriticalSection m_exclusive; // protects writers and the following
     int m_button_v;
-    RadarControlState m_state;
     RadarControlState m_button_s;
     bool m_mod;
     int m_max; // added for Raymarine
@@ -234,8 +263,7 @@ class RadarRangeControlItem : public RadarControlItem {
 public:
     RadarRangeControlItem()
     {
-        m_value = 0;
-        m_state = RCS_OFF;
+        Store(0, RCS_OFF);
         m_button_v = VALUE_NOT_SET; // Unlikely value so that first actual set
                                     // sets proper value + mod
         m_button_s = RCS_OFF;
@@ -250,7 +278,7 @@ public:
             m_mod = true;
             m_button_v = v;
         }
-        m_value = v;
+        Store(v, GetState());
     };
 };
 
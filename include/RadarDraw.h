@@ -32,6 +32,7 @@
 #ifndef _RADAR_DRAW_H_
 #define _RADAR_DRAW_H_
 
+#include "SpokePreprocess.h"
 #include "radar_pi.h"
 
 PLUGIN_BEGIN_NAMESPACE
@@ -45,9 +46,16 @@ public:
         = 0;
     virtual void DrawRadarPanelImage(double panel_scale, double panel_rotate)
         = 0;
+    // `runs` come from ColourSpoke, the same for the panel and the overlay;
+    // `transparency` and `angle` are what differs between them.
     virtual void ProcessRadarSpoke(int transparency, SpokeBearing angle,
-        uint8_t* data, size_t len, GeoPosition spoke_pos)
+        const BlobRun* runs, size_t len, GeoPosition spoke_pos)
         = 0;
+    // Scales the spokes that are there by zoom and moves them rotate spokes
+    // on, so the picture survives a range or orientation change.
+    virtual void ResampleSpokes(double zoom, int rotate) = 0;
+    // A line for the statistics box, or empty
+    virtual wxString GetStatistics() { return wxEmptyString; }
 
     virtual ~RadarDraw() = 0;
 
@@ -36,21 +36,46 @@
 
 PLUGIN_BEGIN_NAMESPACE
 
-#define SHADER_COLOR_CHANNELS (4) // RGB + Alpha
+#define SHADER_COLOR_CHANNELS (4) // RGB + Alpha, of the palette
+#define SHADER_PALETTE_SIZE (256) // palette entries, indexed by BlobColour
+#define SHADER_OFFSET_RANGE (2047.) // meters, the furthest spoke offset
 
 class RadarDrawShader : public RadarDraw {
 public:
-    RadarDrawShader(RadarInfo* ri)
+    RadarDrawShader(RadarInfo* ri, bool polar_mesh = false)
     {
         m_ri = ri;
+        m_polar_mesh = polar_mesh;
+        m_smoothing = false;
+        m_mesh = 0;
+        m_mesh_vertices = 0;
+        m_mesh_vbo = 0;
         m_start_line = -1; // No spokes received since last draw
         m_lines = 0;
         m_texture = 0;
+        m_palette_texture = 0;
+        m_offset_texture = 0;
+        m_uniform_position = -1;
+        m_uniform_scale = -1;
+        m_uniform_moving = -1;
+        m_spoke_pos = 0;
+        m_offset_data = 0;
+        m_offset_upload = 0;
+        m_reference_set = false;
+        m_offsets_dirty = false;
+        m_still_spokes = 0;
+        m_last_pos.lat = 0.;
+        m_last_pos.lon = 0.;
+        m_pbo[0] = 0;
+        m_pbo[1] = 0;
+        m_pbo_next = 0;
+        memset(m_palette, 0, sizeof(m_palette));
+        m_alpha = 0;
         m_fragment = 0;
         m_vertex = 0;
         m_program = 0;
-        m_format = GL_RGBA;
-        m_channels = SHADER_COLOR_CHANNELS;
+        m_format = GL_LUMINANCE;
+        m_channels = 1;
         m_data = 0;
         m_spokes = 0;
         m_spoke_len_max = 0;
@@ -59,31 +84,72 @@ public:
     ~RadarDrawShader();
 
     bool Init(size_t spokes, size_t spoke_len_max);
+    bool InitData(size_t spokes, size_t spoke_len_max);
     void DrawRadarOverlayImage(double radar_scale, double panel_rotate);
     void DrawRadarPanelImage(double panel_scale, double panel_rotate);
-    void ProcessRadarSpoke(int transparency, SpokeBearing angle, uint8_t* data,
-        size_t len, GeoPosition spoke_pos);
+    void ProcessRadarSpoke(int transparency, SpokeBearing angle,
+        const BlobRun* runs, size_t len, GeoPosition spoke_pos);
+    void ResampleSpokes(double zoom, int rotate);
 
 private:
     RadarInfo* m_ri;
+    bool m_polar_mesh; // draw a polar mesh instead of a square that the shader converts
+    bool m_smoothing; // blend the colours of neighbouring samples, see FRAGMENT_SHADER_FILTER
+
+    struct MeshVertex {
+        GLfloat x;
+        GLfloat y;
+        GLfloat radius; // 0 .. 1
+        GLfloat angle; // times radius, 0 .. 1 for a circle
+        GLfloat north; // meters from m_reference where the spoke was received, see UpdateMeshOffsets()
+        GLfloat east;
+    };
+    MeshVertex* m_mesh;
+    size_t m_mesh_vertices;
+    GLuint m_mesh_vbo;
 
     wxCriticalSection m_exclusive; // protects the following data structures
-    unsigned char*
-        m_data; // [SHADER_COLOR_CHANNELS * m_spokes * m_spoke_len_max];
+    unsigned char* m_data; // [m_spokes * m_spoke_len_max], BlobColour
     size_t m_spokes;
     size_t m_spoke_len_max;
 
     int m_start_line; // First line received since last draw, or -1
     int m_lines; // # of lines received since last draw
 
+    GeoPosition* m_spoke_pos; // [m_spokes], where each spoke was received
+    unsigned char* m_offset_data; // [SHADER_COLOR_CHANNELS * m_spokes], see SetOffset()
+    unsigned char* m_offset_upload; // copy of m_offset_data, sent without holding the lock
+    GeoPosition m_reference; // m_offset_data is relative to this
+    bool m_reference_set;
+    bool m_offsets_dirty;
+    GeoPosition m_last_pos; // of the last spoke
+    size_t m_still_spokes; // received in a row at m_last_pos
+
     int m_format;
     int m_channels;
 
     GLuint m_texture;
+    GLuint m_palette_texture;
+    GLuint m_offset_texture;
+    GLint m_uniform_position;
+    GLint m_uniform_scale;
+    GLint m_uniform_moving;
+    GLubyte m_palette[SHADER_PALETTE_SIZE * SHADER_COLOR_CHANNELS]; // as uploaded
+    GLubyte m_alpha; // of the last spoke
+    GLuint m_pbo[2]; // pixel buffers for the uploads, or 0
+    int m_pbo_next; // the one for the next upload
     GLuint m_fragment;
     GLuint m_vertex;
     GLuint m_program;
 
+    bool MakeMesh();
+    void DrawMesh();
+    void UpdateMeshOffsets(const unsigned char* offsets);
+    bool SetOffset(size_t spoke);
+    void UpdateMotion();
+    void UpdatePalette();
+    void UploadSpokes();
+    void UploadLines(const unsigned char* pixels, int start_line, int lines);
     void Reset();
 };
 
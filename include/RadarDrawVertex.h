@@ -33,11 +33,13 @@
 #define _RADARDRAWVERTEX_H_
 
 #include "RadarDraw.h"
+#include "VertexArena.h"
 #include "drawutil.h"
+#include "shaderutil.h"
 
 PLUGIN_BEGIN_NAMESPACE
 
-#define BUFFER_SIZE (2000000)
+#define BUFFER_SIZE (2000000) // vertices, at most, in the arena of each RadarDrawVertex
 
 class RadarDrawVertex : public RadarDraw {
 public:
@@ -47,23 +49,44 @@ public:
 
         m_ri = ri;
         m_vertices = 0;
-        m_count = 0;
+        m_arena = 0;
+        m_run_arena = 0;
+        m_merge = false;
+        m_sector_spokes = 0;
+        m_sectors = 0;
+        m_sector_dirty = 0;
+        m_open = 0;
+        m_next = 0;
+        m_merge_span = 0;
+        m_line_vertices = 0;
+        m_lines_used = 0;
         m_oom = false;
         m_spokes = 0;
         m_spoke_len_max = 0;
+        m_vbo = 0;
+        m_vbo_vertices = 0;
+        m_vbo_generation = 0;
+        m_batch_first = 0;
+        m_batch_count = 0;
+        m_batch_lines = 0;
     }
 
     bool Init(size_t spokes, size_t spoke_len_max);
     void DrawRadarOverlayImage(double radar_scale, double panel_rotate);
     void DrawRadarPanelImage(double panel_scale, double panel_rotate);
-    void ProcessRadarSpoke(int transparency, SpokeBearing angle, uint8_t* data,
-        size_t len, GeoPosition spoke_pos);
+    void ProcessRadarSpoke(int transparency, SpokeBearing angle,
+        const BlobRun* runs, size_t len, GeoPosition spoke_pos);
+    void ResampleSpokes(double zoom, int rotate);
+    wxString GetStatistics();
 
     ~RadarDrawVertex()
     {
         wxCriticalSectionLocker lock(m_exclusive);
 
         Reset();
+        if (m_vbo) {
+            DeleteBuffers(1, &m_vbo);
+        }
     }
 
 private:
@@ -74,6 +97,9 @@ private:
     static const int VERTEX_PER_TRIANGLE = 3;
     static const int VERTEX_PER_QUAD = 2 * VERTEX_PER_TRIANGLE;
     static const int MAX_BLOBS_PER_LINE = SPOKE_LEN_MAX;
+    static const int MIN_SLOT = 16 * VERTEX_PER_QUAD;
+    static const int MIN_RUN_SLOT = 16;
+    static const int SECTORS = 64; // merged blobs span 1/64 of a circle at most
 
     struct VertexPoint {
         Point xy;
@@ -83,22 +109,88 @@ private:
         GLubyte alpha;
     };
 
+    // A blob of one spoke, kept when merging so the blobs that it is part of
+    // can be built again
+    struct VertexRun {
+        uint16_t r1;
+        uint16_t r2;
+        GLubyte red;
+        GLubyte green;
+        GLubyte blue;
+        GLubyte alpha;
+    };
+
+    struct MergeRun {
+        VertexRun run;
+        size_t begin; // first spoke of the merged blob
+    };
+
     struct VertexLine {
-        VertexPoint* points;
+        VertexSlot slot; // the points, in m_arena and at the same place in m_vbo
+        VertexSlot runs; // when merging, the blobs of this spoke in m_run_arena
+        size_t run_count;
         time_t timeout;
         size_t count;
-        size_t allocated;
         GeoPosition spoke_pos;
+        bool dirty; // points changed since they were copied to m_vbo
     };
 
+    VertexPoint* GetPoints(VertexLine* line)
+    {
+        return (VertexPoint*)m_arena->Get(line->slot);
+    }
+    VertexRun* GetRuns(VertexLine* line)
+    {
+        return (VertexRun*)m_run_arena->Get(line->runs);
+    }
+
     void SetBlob(VertexLine* line, int angle_begin, int angle_end, int r1,
         int r2, GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha);
+    void AddBlob(VertexLine* line, int angle, int r1, int r2, GLubyte red,
+        GLubyte green, GLubyte blue, GLubyte alpha);
+    void CompactLine(VertexLine* line);
+
+    // When merging, a spoke only keeps its runs, and the blobs of a sector
+    // are built from them before drawing. Runs with the same radii and colour
+    // on adjacent spokes, with the same position and timeout, become one
+    // blob that belongs to (is drawn with) its first spoke. Blobs never cross
+    // a sector, so rewriting a spoke only invalidates its own sector. A blob
+    // is drawn as a quad, so its outer edge is a chord; m_merge_span keeps
+    // that chord within half a sample of the arc that single spokes draw.
+    void MergeSectors();
+    void MergeSector(size_t sector);
+    void SetMergedBlob(const MergeRun& blob, size_t end);
+
+    // m_vbo is a copy of the arena, so every line has its own slot there.
+    // Only changed lines are copied to it, and the lines are drawn with one
+    // glMultiDrawArrays for each run of lines with the same spoke_pos.
+    bool BindVertices();
+    void UnbindVertices();
+    void DrawLine(VertexLine* line);
+    void FlushLines();
 
     void Reset();
     wxCriticalSection m_exclusive; // protects the following
     VertexLine* m_vertices;
-    unsigned int m_count;
+    VertexArena* m_arena; // all points of all lines
+    VertexArena* m_run_arena; // all runs of all lines, when merging
+    bool m_merge;
+    size_t m_sector_spokes;
+    size_t m_sectors;
+    bool* m_sector_dirty; // m_sectors
+    MergeRun* m_open; // MAX_BLOBS_PER_LINE, blobs that may continue on the next spoke
+    MergeRun* m_next; // MAX_BLOBS_PER_LINE
+    uint16_t* m_merge_span; // m_spoke_len_max + 1, most spokes a blob ending at that radius may span
+    size_t m_line_vertices; // the sum of the count of all lines
+    size_t m_lines_used; // lines that have a slot
     bool m_oom;
+
+    GLuint m_vbo; // 0 before the first draw, or without buffer objects
+    size_t m_vbo_vertices; // size of m_vbo
+    unsigned int m_vbo_generation; // of m_arena when m_vbo was sized
+    GLint* m_batch_first; // m_spokes, lines waiting for FlushLines()
+    GLsizei* m_batch_count; // m_spokes
+    size_t m_batch_lines;
 };
 
 PLUGIN_END_NAMESPACE
@@ -33,8 +33,12 @@
 #define _RADAR_INFO_H_
 
 #include "ControlsDialog.h"
+#include "LatencyHistogram.h"
+#include "PolarToCartesianLookup.h"
 #include "RadarControlItem.h"
 #include "RadarReceive.h"
+#include "SpokeWorkers.h"
+#include "TrailAge.h"
 #include "radar_pi.h"
 
 PLUGIN_BEGIN_NAMESPACE
@@ -52,8 +56,6 @@ struct DrawInfo {
     bool color_option;
 };
 
-#define SECONDS_TO_REVOLUTIONS(x) ((x) * 2 / 5)
-#define TRAIL_MAX_REVOLUTIONS SECONDS_TO_REVOLUTIONS(600) + 1
 enum {
     TRAIL_15SEC,
     TRAIL_30SEC,
@@ -186,6 +188,12 @@ public:
                                // addresses + serial nr)
     RadarControl* m_control;
     RadarReceive* m_receive;
+    RadarProcess* m_process; // Runs ProcessRadarSpoke on spokes from m_spoke_queue
+    SpokeWorkers* m_workers; // Runs the spoke consumers in parallel, if configured
+    SpokeQueue* m_spoke_queue; // Filled by m_receive, lock free
+    PacketRecorder* m_recorder; // Records what m_receive receives, if set in config
+    PacketCapture* m_capture; // Last packets received, dumped on request
+    LatencyStats m_latency; // Time spent per spoke processing stage
     ControlsDialog* m_control_dialog;
     RadarPanel* m_radar_panel;
     RadarCanvas* m_radar_canvas;
@@ -217,8 +225,6 @@ public:
     line_history* m_history;
 
     int m_old_range;
-    int m_dir_lat;
-    int m_dir_lon;
     TrailBuffer* m_trails;
 
     // Timed Transmit
@@ -231,8 +237,12 @@ public:
     ~RadarInfo();
 
     bool Init();
+    void InitSpokeProcessing();
     void SetName(wxString name);
     wxString GetInfoStatus();
+    // RecordFile or ReplayFile with the radar number added to the name, so
+    // that every radar has its own recording: /x/halo.rec -> /x/halo-0.rec
+    wxString GetPacketFile(const wxString& path);
 
     void AdjustRange(int adjustment);
     void SetAutoRangeMeters(int meters);
@@ -240,6 +250,10 @@ public:
         RadarControlButton* button);
     void ProcessRadarSpoke(SpokeBearing angle, SpokeBearing bearing,
         uint8_t* data, size_t len, int range_meters, wxLongLong time);
+    void ProcessRadarReset();
+    void ConsumeRadarSpoke(SpokeLane lane, const SpokeJob& job);
+    void QueueRadarSpoke(SpokeBearing angle, SpokeBearing bearing,
+        uint8_t* data, size_t len, int range_meters, wxLongLong time);
     void RefreshDisplay();
     void RenderGuardZone();
     void ResetRadarImage();
@@ -321,6 +335,7 @@ public:
     wxString GetCanvasTextCenter();
     wxString GetTimedIdleText();
     wxString GetRadarStateText();
+    wxString GetDrawStatistics();
 
     bool HaveRadarSerialNo(size_t r);
     RadarLocationInfo GetRadarLocationInfo();
@@ -336,7 +351,7 @@ public:
     // Speedup lookup tables of color to r,g,b, set dependent on
     // m_settings.display_option.
     PixelColour m_colour_map_rgb[BLOB_COLOURS];
-    BlobColour m_colour_map[UINT8_MAX + 1];
+    uint8_t m_colour_map[UINT8_MAX + 1]; // BlobColour, for ColourSpoke
 
     // Speedup PolarToCartesian lookup (angle,radius) -> (x, y)
     PolarToCartesianLookup* m_polar_lookup;
@@ -356,8 +371,10 @@ public:
 
 private:
     void ResetSpokes();
+    void ResampleSpokes(double zoom, int panel_rotate);
     void RenderRadarImage2(
         DrawInfo* di, double radar_scale, double panel_rotate);
+    bool MakeDraw(DrawInfo* di);
     wxString FormatDistance(double distance);
     wxString FormatAngle(double angle);
 
@@ -373,7 +390,7 @@ private:
 
     wxString m_range_text;
 
-    BlobColour m_trail_colour[TRAIL_MAX_REVOLUTIONS + 1];
+    uint8_t m_trail_colour[TRAIL_MAX_REVOLUTIONS + 1]; // BlobColour per trail age
 
     int m_previous_orientation;
 
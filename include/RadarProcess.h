@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _RADARPROCESS_H_
+#define _RADARPROCESS_H_
+
+#include "radar_pi.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+class SpokeQueue;
+
+//
+// The thread that takes decoded spokes from the SpokeQueue filled by the
+// receive thread and runs them through RadarInfo::ProcessRadarSpoke
+// (history, guard zones, trails and the draw buffers).
+//
+
+class RadarProcess : public wxThread {
+public:
+    RadarProcess(radar_pi* pi, RadarInfo* ri, SpokeQueue* queue)
+        : wxThread(wxTHREAD_JOINABLE)
+    {
+        Create(1024 * 1024); // Stack size, be liberal
+        m_pi = pi;
+        m_ri = ri;
+        m_queue = queue;
+        m_shutdown = false;
+    }
+
+    virtual ~RadarProcess() { }
+
+    void* Entry(void);
+    void Shutdown(void);
+
+private:
+    radar_pi* m_pi;
+    RadarInfo* m_ri;
+    SpokeQueue* m_queue;
+
+    volatile bool m_shutdown;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _RADARPROCESS_H_ */
@@ -32,6 +32,7 @@
 #ifndef _RADARRECEIVE_H_
 #define _RADARRECEIVE_H_
 
+#include "PacketRecorder.h"
 #include "RadarControl.h"
 
 PLUGIN_BEGIN_NAMESPACE
@@ -49,6 +50,7 @@ public:
         Create(1024 * 1024); // Stack size, be liberal
         m_pi = pi; // This allows you to access the main plugin stuff
         m_ri = ri; // and this the per-radar stuff
+        m_recorder = 0;
     }
 
     virtual ~RadarReceive() { }
@@ -77,9 +79,33 @@ public:
     virtual void Shutdown(void) = 0;
     virtual SOCKET GetCommSocket() { return INVALID_SOCKET; }
 
+    /*
+     * ReplayPacket
+     *
+     * Process a datagram taken from a packet recording as if it had just
+     * been received on the given channel. Called by ReplayReceive::Entry().
+     */
+    virtual void ReplayPacket(PacketChannel channel, const uint8_t* data, size_t len) { }
+
+    /*
+     * SetRecorder
+     *
+     * When set before the thread is started, every datagram received is also
+     * written to the recorder. Owned by RadarInfo.
+     */
+    void SetRecorder(PacketRecorder* recorder) { m_recorder = recorder; }
+
 protected:
+    void RecordPacket(PacketChannel channel, const uint8_t* data, int len)
+    {
+        if (m_recorder && len > 0) {
+            m_recorder->Record(channel, data, (size_t)len);
+        }
+    }
+
     radar_pi* m_pi;
     RadarInfo* m_ri;
+    PacketRecorder* m_recorder;
 };
 
 PLUGIN_END_NAMESPACE
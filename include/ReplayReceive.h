@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _REPLAYRECEIVE_H_
+#define _REPLAYRECEIVE_H_
+
+#include "PacketRecorder.h"
+#include "RadarInfo.h"
+#include "emulator/EmulatorReceive.h"
+#include "garminhd/GarminHDReceive.h"
+#include "garminxhd/GarminxHDReceive.h"
+#include "navico/NavicoReceive.h"
+#include "raymarine/RaymarineReceive.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// A receive thread that does not talk to the network, but feeds the packets
+// of a recording (see PacketRecorder) to the decoder of the radar type R.
+// Everything downstream of ProcessFrame/ProcessReport runs exactly as with
+// a live radar.
+//
+// RadarFactory::MakeRadarReceive creates one of these instead of the normal
+// receive thread when the ini file contains a ReplayFile.
+//
+
+template <class R>
+class ReplayReceive : public R {
+public:
+    template <typename... Args>
+    ReplayReceive(radar_pi* pi, RadarInfo* ri, Args... args)
+        : R(pi, ri, args...)
+    {
+        m_replay_shutdown = false;
+    }
+
+    void* Entry(void)
+    {
+        PacketReplay replay;
+
+        LOG_VERBOSE(wxT("%s replay thread starting"), this->m_ri->m_name.c_str());
+        if (replay.Open(this->m_ri->GetPacketFile(this->m_pi->m_settings.replay_file),
+                this->m_ri->m_radar_type)) {
+            replay.Play(this, this->m_ri, this->m_pi->m_settings.replay_realtime, &m_replay_shutdown);
+        }
+        LOG_VERBOSE(wxT("%s replay thread stopped"), this->m_ri->m_name.c_str());
+        return 0;
+    }
+
+    void Shutdown(void) { m_replay_shutdown = true; }
+
+    wxString GetInfoStatus()
+    {
+        return _("Replay of") + wxT(" ")
+            + this->m_ri->GetPacketFile(this->m_pi->m_settings.replay_file);
+    }
+
+private:
+    volatile bool m_replay_shutdown;
+};
+
+// Named so that RadarFactory can paste "Replay" in front of the receive class
+// constructor in DEFINE_RADAR.
+typedef ReplayReceive<EmulatorReceive> ReplayEmulatorReceive;
+typedef ReplayReceive<GarminHDReceive> ReplayGarminHDReceive;
+typedef ReplayReceive<GarminxHDReceive> ReplayGarminxHDReceive;
+typedef ReplayReceive<NavicoReceive> ReplayNavicoReceive;
+typedef ReplayReceive<RaymarineReceive> ReplayRaymarineReceive;
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _REPLAYRECEIVE_H_ */
@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _SPOKEPREPROCESS_H_
+#define _SPOKEPREPROCESS_H_
+
+#include "pi_common.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// First step of RadarInfo::ProcessRadarSpoke, done in one pass over the
+// spoke: clear the main bang, drop returns below the threshold and fill
+// the history line used by ARPA and the guard zones:
+//
+//   0xC0 (1100 0000) return >= weakest_normal_blob
+//   0xE0 (1110 0000) return is 255, an approaching doppler target
+//   0x00             anything else, and everything beyond len
+//
+// The loop body uses selects instead of branches so the compiler can
+// vectorize it. There are separate instances for threshold on/off and
+// doppler on/off; with both off the body is just two compares.
+//
+
+// `threshold` is in sample units (0 = off), not the 0..100 control value.
+// Returns the number of doppler returns, or 0 when `doppler` is false.
+extern size_t PreprocessSpoke(uint8_t* data, size_t len, uint8_t* history,
+    size_t history_len, size_t main_bang, uint8_t threshold,
+    uint8_t weakest_normal_blob, bool doppler);
+
+//
+// Last step before drawing: the spoke as runs of samples with the same
+// colour, shared by the panel and the overlay so that the colour map is
+// only walked once per spoke. BLOB_NONE (0) is left out, and the list ends
+// with a run that has r2 == 0, so `runs` needs room for len + 1 runs.
+// The runs do not depend on the angle or the transparency; each view
+// applies its own.
+//
+
+struct BlobRun {
+    uint16_t r1; // first sample
+    uint16_t r2; // one beyond the last sample
+    uint8_t colour; // BlobColour
+};
+
+// `colour_map` is RadarInfo::m_colour_map. Returns the number of runs,
+// not counting the end.
+extern size_t ColourSpoke(const uint8_t* data, size_t len,
+    const uint8_t* colour_map, BlobRun* runs);
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _SPOKEPREPROCESS_H_ */
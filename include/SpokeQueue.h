@@ -0,0 +1,148 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _SPOKEQUEUE_H_
+#define _SPOKEQUEUE_H_
+
+#include <atomic>
+
+#include "radar_pi.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// A single producer, single consumer ring of spokes.
+//
+// The receive thread copies each decoded spoke into the next free slot and
+// publishes it; the process thread (see RadarProcess) picks it up from there.
+// Neither side ever takes a lock, so a slow renderer holding
+// RadarInfo::m_exclusive can no longer stall the socket reader. When the ring
+// is full the spoke is dropped and counted instead of blocking the receiver.
+//
+
+struct QueuedSpoke {
+    SpokeBearing angle;
+    SpokeBearing bearing;
+    size_t len;
+    int range_meters;
+    wxLongLong time;
+    bool reset; // not a spoke: clear the picture before the spokes after it
+    uint8_t* data; // points into the ring, m_spoke_len_max bytes
+};
+
+class SpokeQueue {
+public:
+    SpokeQueue(size_t spokes, size_t spoke_len_max);
+    ~SpokeQueue();
+
+    // Producer side: copy the spoke into the ring, false when it was dropped.
+    bool Push(SpokeBearing angle, SpokeBearing bearing, const uint8_t* data,
+        size_t len, int range_meters, wxLongLong time);
+
+    // Producer side: queue a reset of the picture behind the spokes already
+    // queued. When the ring is full it goes in ahead of the next spoke.
+    void PushReset();
+
+    // Consumer side: the oldest spoke, or 0 when the ring is empty.
+    QueuedSpoke* Front()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return 0;
+        }
+        return &m_slots[tail & m_mask];
+    }
+
+    // Consumer side: release the slot returned by Front().
+    void Pop() { m_tail.fetch_add(1, std::memory_order_release); }
+
+    // Consumer side: sleep until a spoke is committed, Wake() is called or the
+    // timeout expires.
+    void WaitForData(unsigned long timeout_ms);
+    void Wake() { m_wakeup.Post(); }
+
+    size_t GetCapacity() { return m_capacity; }
+    size_t GetSpokeLenMax() { return m_spoke_len_max; }
+    size_t GetDepth()
+    {
+        return m_head.load(std::memory_order_acquire)
+            - m_tail.load(std::memory_order_acquire);
+    }
+
+    // Copy depth, high-water and drops into the statistics, and start a new
+    // measurement interval for the latter two.
+    void GetStatistics(receive_statistics* statistics);
+    void ResetStatistics();
+
+private:
+    // Returns the slot for the next spoke, or 0 when the ring is full.
+    QueuedSpoke* Reserve()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= m_capacity) {
+            return 0;
+        }
+        return &m_slots[head & m_mask];
+    }
+
+    // Makes the slot returned by Reserve() visible to the consumer.
+    void Commit()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed) + 1;
+        m_head.store(head, std::memory_order_seq_cst);
+
+        size_t depth = head - m_tail.load(std::memory_order_relaxed);
+        if (depth > m_high_water.load(std::memory_order_relaxed)) {
+            m_high_water.store(depth, std::memory_order_relaxed);
+        }
+        if (m_waiting.exchange(false, std::memory_order_seq_cst)) {
+            m_wakeup.Post();
+        }
+    }
+
+    size_t m_capacity; // always a power of two
+    size_t m_mask;
+    size_t m_spoke_len_max;
+    QueuedSpoke* m_slots;
+    uint8_t* m_data;
+    bool m_reset_pending; // only used by the producer
+
+    alignas(64) std::atomic<size_t> m_head; // only written by the producer
+    alignas(64) std::atomic<size_t> m_tail; // only written by the consumer
+    alignas(64) std::atomic<size_t> m_high_water;
+    std::atomic<size_t> m_dropped;
+    std::atomic<bool> m_waiting;
+    wxSemaphore m_wakeup;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _SPOKEQUEUE_H_ */
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _SPOKERESAMPLE_H_
+#define _SPOKERESAMPLE_H_
+
+#include "pi_common.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// Keep the picture when the range or orientation changes. Instead of
+// clearing everything and waiting a revolution for new spokes, the spokes
+// that are there are moved to where the new scale or orientation puts them.
+//
+// A spoke is `len` samples of `channels` bytes. The samples at new radius r
+// come from the old radius r / zoom (nearest lower sample), where zoom is
+// new pixels per meter / old pixels per meter. Samples that come from
+// beyond the old spoke are cleared. This works in place.
+//
+extern void ZoomSpoke(
+    uint8_t* spoke, size_t len, size_t channels, double zoom);
+
+// Moves spoke i of an image of `spokes` spokes of `stride` bytes to spoke
+// i + rotate, modulo spokes.
+extern void RotateSpokes(
+    uint8_t* image, size_t spokes, size_t stride, int rotate);
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _SPOKERESAMPLE_H_ */
@@ -0,0 +1,130 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _SPOKEWORKERS_H_
+#define _SPOKEWORKERS_H_
+
+#include "SpokePreprocess.h"
+#include "radar_pi.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// Runs the consumers of a preprocessed spoke (guard zones, trails and the
+// two draw methods) on a small pool of worker threads.
+//
+// Each consumer is a lane. A lane handles the spokes one by one in the order
+// they were submitted, so per lane the bearings are seen in the same order as
+// before, but different lanes work on different spokes at the same time. Idle
+// workers pick whichever lane has work that is ready. The draws that show
+// trails wait for the trails lane to be done with that spoke, which also
+// colours the spoke once for both of them.
+//
+// The process thread submits spokes while it holds RadarInfo::m_exclusive,
+// and calls Wait() before it releases the lock, so the consumers never run
+// while the GUI thread changes things under that lock. For the same reason
+// a consumer must never take that lock itself; what it needs is in the job.
+//
+
+enum SpokeLane {
+    LANE_GUARD_ZONE,
+    LANE_TRAILS, // trail position, true and relative trails
+    LANE_DRAW_OVERLAY,
+    LANE_DRAW_PANEL,
+    SPOKE_LANES
+};
+
+#define SPOKE_LANE(x) (1 << (x))
+
+struct SpokeJob {
+    SpokeBearing angle;
+    SpokeBearing bearing;
+    SpokeBearing panel_angle; // angle or bearing, depending on orientation
+    size_t len;
+    size_t trail_len;
+    GeoPosition pos;
+    int overlay_transparency;
+    bool overlay_after_trails; // overlay shows trails, so draw from `trailed`
+    unsigned int lanes; // SPOKE_LANE() of each active consumer
+    uint8_t* raw; // as preprocessed, for the guard zones
+    uint8_t* shown; // with the extreme range mark
+    uint8_t* trailed; // shown + trails, filled in by the trails lane
+    BlobRun* shown_runs; // ColourSpoke(shown), by the overlay lane without trails
+    BlobRun* trailed_runs; // ColourSpoke(trailed), by the trails lane for the draws
+};
+
+class SpokeWorker;
+
+class SpokeWorkers {
+public:
+    SpokeWorkers(RadarInfo* ri, int threads, size_t spoke_len_max);
+    ~SpokeWorkers();
+
+    // A free job with its buffer, waits if all are in flight.
+    SpokeJob* NewJob();
+    void Submit(SpokeJob* job);
+
+    // Wait until every lane is done with every submitted job
+    void Wait();
+
+    int GetThreads() { return m_thread_count; }
+
+    // First core for `radar` when threads are pinned, or -1
+    static int GetFirstCore(radar_pi* pi, int radar);
+    static void PinToCore(int core);
+
+    void* Run(int index); // Worker thread main loop
+
+private:
+    static const size_t SPOKE_JOBS = 64;
+
+    bool NextTask(int* lane, SpokeJob** job);
+    bool IsIdle();
+
+    RadarInfo* m_ri;
+    int m_thread_count;
+    int m_first_core;
+    SpokeWorker** m_threads;
+    uint8_t* m_buffers;
+    BlobRun* m_runs;
+
+    wxMutex m_mutex; // protects the following
+    wxCondition m_changed; // a job was submitted or a lane made progress
+    SpokeJob m_jobs[SPOKE_JOBS];
+    size_t m_submitted; // jobs submitted so far
+    size_t m_next[SPOKE_LANES]; // next job for each lane
+    bool m_busy[SPOKE_LANES];
+    bool m_shutdown;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _SPOKEWORKERS_H_ */
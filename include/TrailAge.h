@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _TRAIL_AGE_H_
+#define _TRAIL_AGE_H_
+
+#include "pi_common.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+#define SECONDS_TO_REVOLUTIONS(x) ((x) * 2 / 5)
+#define TRAIL_MAX_REVOLUTIONS (SECONDS_TO_REVOLUTIONS(600) + 1)
+
+typedef uint8_t TrailRevolutionsAge;
+
+//
+// Trail pixels hold the revolution in which they last had a strong return,
+// not their age. The age is computed when a pixel is read, so a sweep only
+// writes the pixels that have a return and leaves the others alone.
+//
+// Revolutions are counted by each trail image when its spoke index wraps.
+// A TrailRevolution of 0 means "no trail", so the counter runs from 1 to
+// TRAIL_REVOLUTION_WRAP and then starts at 1 again (after some 45 hours).
+// Every TRAIL_RENORMALIZE revolutions the pixels that reached
+// TRAIL_MAX_REVOLUTIONS are moved up to be exactly that old; otherwise
+// continuous trails would become young again after the counter wrapped.
+//
+
+typedef uint16_t TrailRevolution;
+
+#define TRAIL_REVOLUTION_WRAP (65535)
+#define TRAIL_RENORMALIZE (8192)
+
+// Number of revolutions from `hit` to `now`, both not 0
+static inline int TrailRevolutionsSince(TrailRevolution now, TrailRevolution hit)
+{
+    int since = (int)now - (int)hit;
+    if (since < 0) {
+        since += TRAIL_REVOLUTION_WRAP;
+    }
+    return since;
+}
+
+// The age as the per-sweep counter used to hold it: 1 in the revolution of
+// the return, one more for every revolution after that, limited to
+// TRAIL_MAX_REVOLUTIONS. 0 if there never was a return.
+static inline TrailRevolutionsAge TrailAge(
+    TrailRevolution now, TrailRevolution hit)
+{
+    if (!hit) {
+        return 0;
+    }
+    int age = TrailRevolutionsSince(now, hit) + 1;
+    if (age > TRAIL_MAX_REVOLUTIONS) {
+        age = TRAIL_MAX_REVOLUTIONS;
+    }
+    return (TrailRevolutionsAge)age;
+}
+
+static inline TrailRevolution NextTrailRevolution(TrailRevolution now)
+{
+    return (now < TRAIL_REVOLUTION_WRAP) ? now + 1 : 1;
+}
+
+// The stamp to store instead of `hit` when renormalizing at `now`
+static inline TrailRevolution RenormalizeTrailRevolution(
+    TrailRevolution now, TrailRevolution hit)
+{
+    if (hit && TrailRevolutionsSince(now, hit) >= TRAIL_MAX_REVOLUTIONS) {
+        int older = (int)now - TRAIL_MAX_REVOLUTIONS;
+        if (older <= 0) {
+            older += TRAIL_REVOLUTION_WRAP;
+        }
+        hit = (TrailRevolution)older;
+    }
+    return hit;
+}
+
+// The colour of every age for trails of `max_revolutions` (0 = off): the
+// `colours` trail colours from `first_colour` on, spread over the ages.
+// Continuous trails all get `first_colour`, like a plotter. Ages that show
+// no trail get 0, BLOB_NONE.
+static inline void ComputeTrailColours(int max_revolutions, bool continuous,
+    uint8_t first_colour, int colours, uint8_t* colour)
+{
+    double colours_per_revolution = 0.;
+    double c = 0.;
+
+    if (max_revolutions > 0 && !continuous) {
+        colours_per_revolution = colours / (double)max_revolutions;
+    }
+    for (int revolution = 0; revolution <= TRAIL_MAX_REVOLUTIONS;
+         revolution++) {
+        if (revolution >= 1 && revolution < max_revolutions) {
+            colour[revolution] = (uint8_t)(first_colour + (int)c);
+            c += colours_per_revolution;
+        } else {
+            colour[revolution] = 0;
+        }
+    }
+}
+
+PLUGIN_END_NAMESPACE
+
+#endif
@@ -33,11 +33,10 @@
 #define _TRAIL_BUFFER_H_
 
 #include "RadarInfo.h"
+#include "TrailTiles.h"
 
 PLUGIN_BEGIN_NAMESPACE
 
-typedef uint8_t TrailRevolutionsAge;
-
 #define MARGIN (100)
 
 class TrailBuffer {
@@ -46,7 +45,7 @@ public:
     ~TrailBuffer();
 
     void ClearTrails();
-    void UpdateTrailPosition();
+    void UpdateTrailPosition(const GeoPosition& radar);
     void UpdateTrueTrails(SpokeBearing bearing, uint8_t* data, size_t len);
     void UpdateRelativeTrails(SpokeBearing angle, uint8_t* data, size_t len);
 
@@ -55,14 +54,18 @@ public:
         int lon;
     };
 
-    GeoPosition m_pos;
+    GeoPosition m_pos; // where the trails were last moved to, NaN after ClearTrails()
     GeoPosition m_dif; // Fraction of a pixel expressed in lat/lon for True
                        // Motion Target Trails
     GeoPositionPixels m_offset;
 
 private:
-    void ShiftImageLonToCenter();
-    void ShiftImageLatToCenter();
+    struct TrailSweep {
+        SpokeBearing index; // last spoke index
+        TrailRevolution revolution; // counts wraps of index
+    };
+
+    bool CountRevolution(TrailSweep* sweep, SpokeBearing index);
     void ZoomTrails(float zoom_factor);
 
     RadarInfo* m_ri;
@@ -70,11 +73,15 @@ private:
     int m_max_spoke_len;
     int m_trail_size;
     double m_previous_pixels_per_meter;
+    TrailSweep m_true_sweep;
+    TrailSweep m_relative_sweep;
 
-    TrailRevolutionsAge* m_true_trails; // m_trails_size * m_trails_size
-    TrailRevolutionsAge* m_relative_trails; // m_spokes * m_max_spoke_len
-    TrailRevolutionsAge* m_copy_true_trails; // m_trails_size * m_trails_size
-    TrailRevolutionsAge* m_copy_relative_trails; // m_spokes * m_max_spoke_len
+    TrailTiles* m_true_trails; // torus of at least m_trails_size squared, sparse
+    TrailRevolution* m_relative_trails; // m_spokes * m_max_spoke_len
+    TrailTiles* m_copy_true_trails; // only holds tiles during zoom
+    TrailRevolution* m_copy_relative_trails; // m_spokes * m_max_spoke_len
+    int* m_zoom_map; // m_trail_size, true trail row or column after zoom
+    int* m_zoom_relative_map; // m_max_spoke_len + 1, first radius that zooms to each radius
 };
 
 PLUGIN_END_NAMESPACE
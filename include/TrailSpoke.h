@@ -0,0 +1,70 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _TRAIL_SPOKE_H_
+#define _TRAIL_SPOKE_H_
+
+#include "PolarToCartesianLookup.h"
+#include "TrailTiles.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// What TrailBuffer does with one spoke, without RadarInfo, so that
+// TrailAge-test runs the same code.
+//
+// Both mark the trail pixels of the strong (>= strong_target) returns with
+// `now`, and when `recolour` is set give the weak (< weak_target) returns
+// the colour of the age of their pixel. The last sample, the range circle,
+// never gets a trail.
+//
+
+struct TrailTargets {
+    uint8_t weak;
+    uint8_t strong;
+    const uint8_t* colour; // per age, see ComputeTrailColours
+};
+
+// `trail` is the row of this spoke, spoke_len_max long. The part beyond
+// len is cleared.
+extern void UpdateRelativeTrailSpoke(TrailRevolution* trail,
+    size_t spoke_len_max, TrailRevolution now, uint8_t* data, size_t len,
+    const TrailTargets& targets, bool recolour);
+
+// The radar is at (center_x, center_y) in `tiles`.
+extern void UpdateTrueTrailSpoke(TrailTiles* tiles,
+    PolarToCartesianLookup* lookup, size_t bearing, int center_x,
+    int center_y, TrailRevolution now, uint8_t* data, size_t len,
+    const TrailTargets& targets, bool recolour);
+
+PLUGIN_END_NAMESPACE
+
+#endif
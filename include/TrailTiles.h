@@ -0,0 +1,136 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _TRAIL_TILES_H_
+#define _TRAIL_TILES_H_
+
+#include "TrailAge.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// A square image of size x size trail revolutions (see TrailAge.h), stored
+// as tiles of TRAIL_TILE x TRAIL_TILE pixels that are only allocated once a
+// return is written into them. A missing tile reads as all zero, so open
+// water costs one pointer per tile instead of a dense plane of several
+// megabytes.
+//
+// Pixel (x, y) is at tile (x / TRAIL_TILE, y / TRAIL_TILE); within a tile y
+// is the fast index, as it was in the dense buffer.
+//
+// The image is a torus: the size is rounded up to a power of two and all
+// coordinates are taken modulo that size, so they may be negative or run past
+// the edge. Moving the origin of the image is then free; the owner only has to
+// clear the strip that newly comes into view.
+//
+
+#define TRAIL_TILE_BITS (6)
+#define TRAIL_TILE (1 << TRAIL_TILE_BITS)
+#define TRAIL_TILE_MASK (TRAIL_TILE - 1)
+#define TRAIL_TILE_PIXELS (TRAIL_TILE * TRAIL_TILE)
+
+class TrailTiles {
+public:
+    TrailTiles(int size);
+    ~TrailTiles();
+
+    int GetSize() { return m_size; }
+    int GetTilesPerRow() { return m_tiles_per_row; }
+
+    // Pointer to pixel (x, y), or 0 if nothing was ever written in its tile
+    TrailRevolution* Find(int x, int y)
+    {
+        x &= m_mask;
+        y &= m_mask;
+        TrailRevolution* tile = m_tiles[TileIndex(x, y)];
+        if (!tile) {
+            return 0;
+        }
+        return tile + PixelIndex(x, y);
+    }
+
+    // Pointer to pixel (x, y), allocating its tile if needed
+    TrailRevolution* Get(int x, int y)
+    {
+        x &= m_mask;
+        y &= m_mask;
+        TrailRevolution** tile = &m_tiles[TileIndex(x, y)];
+        if (!*tile) {
+            *tile = NewTile();
+        }
+        return *tile + PixelIndex(x, y);
+    }
+
+    // The TRAIL_TILE pixels of row x in tile column t, or 0 when not allocated
+    TrailRevolution* FindRow(int x, int t)
+    {
+        x &= m_mask;
+        TrailRevolution* tile = m_tiles[TileIndex(x, t << TRAIL_TILE_BITS)];
+        if (!tile) {
+            return 0;
+        }
+        return tile + PixelIndex(x, 0);
+    }
+
+    // Same, but allocates the tile
+    TrailRevolution* GetRow(int x, int t) { return Get(x, t << TRAIL_TILE_BITS); }
+
+    void Clear(); // Frees all tiles
+    void ClearRows(int x, int rows); // Zero rows x .. x + rows - 1, wrapping
+    void ClearColumns(int y, int columns); // Same for columns y .. y + columns - 1
+    void Swap(TrailTiles& other);
+    void Renormalize(TrailRevolution now); // see RenormalizeTrailRevolution
+
+    size_t GetTileCount() { return m_tile_count; }
+    size_t GetMemoryUsed();
+
+private:
+    size_t TileIndex(int x, int y)
+    {
+        return (x >> TRAIL_TILE_BITS) * m_tiles_per_row + (y >> TRAIL_TILE_BITS);
+    }
+    static size_t PixelIndex(int x, int y)
+    {
+        return ((x & TRAIL_TILE_MASK) << TRAIL_TILE_BITS) + (y & TRAIL_TILE_MASK);
+    }
+    TrailRevolution* NewTile();
+    void ClearRect(int x, int rows, int y, int columns);
+
+    int m_size; // power of two
+    int m_mask; // m_size - 1
+    int m_tiles_per_row;
+    size_t m_tile_count;
+    TrailRevolution** m_tiles; // m_tiles_per_row * m_tiles_per_row
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _VERTEXARENA_H_
+#define _VERTEXARENA_H_
+
+#include "pi_common.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// Slab allocator for the vertices of RadarDrawVertex.
+//
+// All slots live in one block of units (vertices). A slot is min_slot units
+// times a power of two; freed slots go onto a free list per size, linked
+// through the slots themselves. Once the block has grown to what the picture
+// needs, spokes move between sizes without calling malloc or realloc.
+//
+// Slots are offsets, not pointers, so the block can move when it grows; the
+// generation counts those moves. The block never grows beyond max_units.
+//
+
+struct VertexSlot {
+    uint32_t offset; // first unit
+    uint32_t size; // units, 0 when there is no slot
+};
+
+class VertexArena {
+public:
+    VertexArena(size_t unit_size, size_t min_slot, size_t max_units);
+    ~VertexArena();
+
+    // Gets a slot of at least `units`. False when there is no room.
+    bool Alloc(size_t units, VertexSlot* slot);
+    void Free(VertexSlot* slot);
+    // Moves the first `keep` units of the slot to a slot that fits `units`,
+    // bigger or smaller. False when there is no room, the slot is then
+    // unchanged.
+    bool Resize(VertexSlot* slot, size_t keep, size_t units);
+    // Grows the block to at least `units`, up to max_units
+    bool Reserve(size_t units);
+
+    void* Get(const VertexSlot& slot)
+    {
+        return m_data + (size_t)slot.offset * m_unit_size;
+    }
+    void* GetData() { return m_data; }
+    size_t GetCapacity() { return m_capacity; } // units in the block
+    size_t GetUsed() { return m_used; } // units in slots
+    size_t GetPeak() { return m_peak; }
+    size_t GetSlotSize(size_t units); // the slot that Alloc() gives for units
+    unsigned int GetGeneration() { return m_generation; }
+
+private:
+    static const uint32_t NONE = 0xffffffff;
+    static const int CLASSES = 16;
+
+    int ClassOf(size_t units);
+    uint32_t Pop(int c);
+    void Push(int c, uint32_t offset);
+
+    size_t m_unit_size;
+    size_t m_min_slot;
+    size_t m_max_units;
+
+    uint8_t* m_data;
+    size_t m_capacity;
+    size_t m_top; // units handed out from the block so far
+    uint32_t m_free[CLASSES]; // first free slot of each size, or NONE
+
+    size_t m_used;
+    size_t m_peak;
+    unsigned int m_generation;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _VERTEXARENA_H_ */
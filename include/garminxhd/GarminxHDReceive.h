@@ -70,6 +70,7 @@ public:
     void* Entry(void);
     void Shutdown(void);
     wxString GetInfoStatus();
+    void ReplayPacket(PacketChannel channel, const uint8_t* data, size_t len);
 
     NetworkAddress m_interface_addr;
     NetworkAddress m_data_addr;
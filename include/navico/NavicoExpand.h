@@ -0,0 +1,87 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _NAVICOEXPAND_H_
+#define _NAVICOEXPAND_H_
+
+#include "pi_common.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// Expansion of the packed Navico spoke data (two 4 bit returns per byte, low
+// nibble first) to one byte per return, mapped so that there is room for the
+// BLOB_HISTORY colours and the doppler values.
+//
+// lookupData holds the classic per-byte tables; the vector kernels use the
+// equivalent 16 entry per-nibble table with a byte shuffle, and must produce
+// exactly the same output.
+//
+
+enum LookupSpokeEnum {
+    LOOKUP_SPOKE_LOW_NORMAL,
+    LOOKUP_SPOKE_LOW_BOTH,
+    LOOKUP_SPOKE_LOW_APPROACHING,
+    LOOKUP_SPOKE_HIGH_NORMAL,
+    LOOKUP_SPOKE_HIGH_BOTH,
+    LOOKUP_SPOKE_HIGH_APPROACHING
+};
+
+enum NavicoExpandKernel {
+    NAVICO_EXPAND_SCALAR, // Per byte lookup in lookupData
+    NAVICO_EXPAND_SSSE3,
+    NAVICO_EXPAND_AVX2,
+    NAVICO_EXPAND_NEON,
+    NAVICO_EXPAND_KERNELS
+};
+
+extern uint8_t lookupData[6][256];
+
+// Fill lookupData and the nibble tables. Safe to call more than once.
+extern void NavicoInitializeLookupData();
+
+// Expand packed_len bytes from packed into 2 * packed_len bytes in out, using
+// the fastest kernel this CPU supports. doppler is 0 (normal), 1 (both) or
+// 2 (approaching only).
+extern void NavicoExpandSpoke(
+    const uint8_t* packed, uint8_t* out, size_t packed_len, int doppler);
+
+// Same, but with a specific kernel. Returns false if that kernel is not
+// compiled in or not supported by this CPU.
+extern bool NavicoExpandSpokeWith(NavicoExpandKernel kernel,
+    const uint8_t* packed, uint8_t* out, size_t packed_len, int doppler);
+
+extern const char* NavicoExpandKernelName(NavicoExpandKernel kernel);
+extern NavicoExpandKernel NavicoExpandBestKernel();
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _NAVICOEXPAND_H_ */
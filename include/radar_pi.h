@@ -76,6 +76,10 @@ class ControlsDialog;
 class MessageBox;
 class OptionsDialog;
 class RadarReceive;
+class PacketCapture;
+class RadarProcess;
+class SpokeQueue;
+class SpokeWorkers;
 class RadarControl;
 class radar_pi;
 class GuardZoneBogey;
@@ -86,6 +90,23 @@ class NavicoLocate;
 
 class DpRadarCommand;
 
+#ifdef RADAR_BENCH
+// Without an opencpn_plugin base these OpenCPN calls do not accept a radar_pi,
+// and there is no OpenCPN to call anyway. The rest of the API is stubbed in
+// src/bench/OpenCPNStubs.cpp.
+inline int AddCanvasContextMenuItem(wxMenuItem* pitem, radar_pi* pplugin)
+{
+    return -1;
+}
+inline int InsertPlugInToolSVG(wxString label, wxString SVGfile,
+    wxString SVGfileRollover, wxString SVGfileToggled, wxItemKind kind,
+    wxString shortHelp, wxString longHelp, wxObject* clientData, int position,
+    int tool_sel, radar_pi* pplugin)
+{
+    return -1;
+}
+#endif
+
 #define MAX_CHART_CANVAS (2) // How many canvases OpenCPN supports
 #define RADARS                                                                 \
     (1) // Arbitrary limit, anyone running this many is already crazy!
@@ -278,6 +299,9 @@ struct receive_statistics {
     int spokes;
     int broken_spokes;
     int missing_spokes;
+    int queue_depth; // spokes waiting for the process thread
+    int queue_high_water; // deepest the queue has been this interval
+    int queue_dropped; // spokes dropped because the queue was full
 };
 
 typedef enum GuardZoneType { GZ_ARC, GZ_CIRCLE } GuardZoneType;
@@ -531,6 +555,20 @@ struct PersistentSettings {
     GeoPosition fixed_pos;
     wxString radar_description_text;
     NetworkAddress target_mixer_address;
+    wxString record_file; // Record all radar packets to this file, see
+                          // RadarInfo::GetPacketFile
+    wxString replay_file; // Replay radar packets from this file instead of
+                          // listening to the network
+    bool replay_realtime; // Replay at the recorded speed, or as fast as
+                          // possible
+    int capture_packets; // Keep this many raw packets for diagnostics, 0 = off
+    int process_threads; // Worker threads per radar for the spoke consumers,
+                         // 0 = run them on the process thread
+    bool pin_process_threads; // Give each radar's threads their own cores
+    bool merge_vertex_blobs; // Join equal blobs on adjacent spokes when
+                             // drawing with vertex arrays
+    bool shader_smoothing; // Blend the colours of neighbouring samples when
+                           // drawing with shaders, at four times the fetches
 };
 
 // Table for AIS targets inside ARPA zone
@@ -563,7 +601,13 @@ struct AisArpa {
         | WANTS_PLUGIN_MESSAGING | WANTS_CURSOR_LATLON | WANTS_MOUSE_EVENTS    \
         | INSTALLS_CONTEXTMENU_ITEMS)
 
+#ifdef RADAR_BENCH
+// The headless benchmark (src/bench) links the plugin without OpenCPN, so
+// there is no plugin manager to derive from, and nothing to register with.
+class radar_pi : public wxEvtHandler {
+#else
 class radar_pi : public opencpn_plugin_119, public wxEvtHandler {
+#endif
 public:
     radar_pi(void* ppimgr);
     ~radar_pi();
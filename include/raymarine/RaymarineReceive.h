@@ -109,6 +109,7 @@ public:
     void* Entry(void);
     void Shutdown(void);
     wxString GetInfoStatus();
+    void ReplayPacket(PacketChannel channel, const uint8_t* data, size_t len);
     SOCKET GetCommSocket() { return m_comm_socket; }
 
     NetworkAddress m_interface_addr;
@@ -0,0 +1,67 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#ifndef _RAYMARINEUNPACK_H_
+#define _RAYMARINEUNPACK_H_
+
+#include "pi_common.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+//
+// Decoder for the run-length coded Raymarine scan data. A 0x5c byte is an
+// escape followed by a count and a value to repeat; everything else is a
+// literal. The E120 non-HD radars pack two 4 bit returns per byte (low
+// nibble first), HD radars and Quantum send one byte per return.
+//
+// Some E120 spokes are only partially coded: after data_len coded bytes the
+// remainder of the record holds raw returns. These are passed in as the
+// bytes between rle_len and src_len.
+//
+
+#define RM_RLE_ESCAPE (0x5c)
+
+enum RaymarineSpokeFormat {
+    RM_SPOKE_NIBBLES, // E120 non-HD
+    RM_SPOKE_BYTES // E120 HD and Quantum
+};
+
+// Unpack into exactly `returns` bytes in dst (returns is capped at dst_size),
+// padded with zeros when the spoke data is short. Never reads beyond
+// src + src_len nor writes beyond dst + dst_size, whatever the packet says.
+// Returns the number of returns that were actually decoded.
+extern size_t RaymarineUnpackSpoke(RaymarineSpokeFormat format,
+    const uint8_t* src, size_t rle_len, size_t src_len, uint8_t* dst,
+    size_t dst_size, size_t returns);
+
+PLUGIN_END_NAMESPACE
+
+#endif /* _RAYMARINEUNPACK_H_ */
@@ -24,6 +24,9 @@ struct attrib_info {
 
 extern GLboolean ShadersSupported(void);
 
+// Buffer objects and glMultiDrawArrays (OpenGL 1.5), for RadarDrawVertex
+extern GLboolean VertexBuffersSupported(void);
+
 extern bool CompileShaderText(
     GLuint* shader, GLenum shaderType, const char* text);
 
@@ -52,4 +55,11 @@ PLUGIN_END_NAMESPACE
 #include "shaderutil.inc"
 #undef SHADER_FUNCTION_LIST
 
+/*
+ * And these after calling VertexBuffersSupported.
+ */
+#define VERTEX_BUFFER_FUNCTION_LIST(proc, name) extern proc name;
+#include "shaderutil.inc"
+#undef VERTEX_BUFFER_FUNCTION_LIST
+
 #endif /* SHADER_UTIL_H */
@@ -1256,6 +1256,26 @@ void Arpa::ClearContours() {
   }
 }
 
+// The spoke scale changed by zoom. The targets themselves are kept as positions and keep being tracked
+// in the resampled history, only the contours are in spoke pixels.
+void Arpa::ZoomContours(double zoom) {
+  for (int i = 0; i < m_number_of_targets; i++) {
+    ArpaTarget *t = m_targets[i];
+
+    for (int j = 0; j < t->m_contour_length; j++) {
+      t->m_contour[j].r = (int)(t->m_contour[j].r * zoom);
+      if (t->m_contour[j].r >= (int)m_ri->m_spoke_len_max) {
+        t->m_contour_length = 0;  // now beyond the end of the spokes
+      }
+    }
+    t->m_max_angle.r = (int)(t->m_max_angle.r * zoom);
+    t->m_min_angle.r = (int)(t->m_min_angle.r * zoom);
+    t->m_max_r.r = (int)(t->m_max_r.r * zoom);
+    t->m_min_r.r = (int)(t->m_min_r.r * zoom);
+    t->m_expected.r = (int)(t->m_expected.r * zoom);
+  }
+}
+
 bool Arpa::IsAtLeastOneRadarTransmitting() {
   for (size_t r = 0; r < RADARS; r++) {
     if (m_pi->m_radar[r] != NULL && m_pi->m_radar[r]->m_state.GetValue() == RADAR_TRANSMIT) {
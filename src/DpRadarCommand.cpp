@@ -6,6 +6,7 @@
 #include "RadarInfo.h"
 
 #include "GuardZone.h"
+#include "PacketCapture.h"
 
 PLUGIN_BEGIN_NAMESPACE
 
@@ -220,6 +221,43 @@ void DpRadarCommand::initActions() {
               SendToDp(ri, { {"SeaClutter", sea} });
             }
         },
+        {
+            "DumpPacketCapture",
+            [this](RadarInfo* ri, const wxJSONValue& val) {
+                int dumped = 0;
+                if (ri->m_capture) {
+                    dumped = (int)ri->m_capture->Dump(ri->m_name);
+                }
+                SendToDp(ri, {{"PacketCaptureDumped", dumped}});
+            }
+        },
+        {
+            "LatencyStats",
+            [this](RadarInfo* ri, const wxJSONValue& val) {
+                ri->m_latency.Enable(val.AsBool());
+
+                SendToDp(ri, {{"LatencyStats", ri->m_latency.IsEnabled()}});
+            }
+        },
+        {
+            "GetLatencyStats",
+            [this](RadarInfo* ri, const wxJSONValue& val) {
+                wxJSONValue root;
+
+                root["LatencyStats"] = ri->m_latency.IsEnabled();
+                for (int s = 0; s < LATENCY_STAGES; s++) {
+                    LatencyHistogram& h = ri->m_latency.GetStage((LatencyStage)s);
+                    wxString name = LatencyStats::GetStageName((LatencyStage)s);
+
+                    // Values in microseconds
+                    root["Latency"][name]["Count"] = (double)h.GetCount();
+                    root["Latency"][name]["P50"] = h.GetPercentile(50.) / 1000.;
+                    root["Latency"][name]["P99"] = h.GetPercentile(99.) / 1000.;
+                    root["Latency"][name]["Max"] = h.GetMax() / 1000.;
+                }
+                SendToDp(ri, root);
+            }
+        },
         {
             "ClearTrails",
             [this](RadarInfo* ri, const wxJSONValue& val) {
@@ -409,8 +447,6 @@ void DpRadarCommand::SendToDp(RadarInfo* ri, std::initializer_list<std::pair<con
 {
     wxJSONValue root;
 
-    root["RadarIndex"] = ri->m_radar;
-  
     for (auto& kv : values) {
         const wxString& key = kv.first;
         const wxVariant& val = kv.second;
@@ -432,6 +468,13 @@ void DpRadarCommand::SendToDp(RadarInfo* ri, std::initializer_list<std::pair<con
         }
     }
 
+    SendToDp(ri, root);
+}
+
+void DpRadarCommand::SendToDp(RadarInfo* ri, wxJSONValue& root)
+{
+    root["RadarIndex"] = ri->m_radar;
+
     wxJSONWriter writer;
     wxString serializedMessage;
     writer.Write(root, serializedMessage);
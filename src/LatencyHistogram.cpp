@@ -0,0 +1,116 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "LatencyHistogram.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+static const char *stage_names[LATENCY_STAGES] = {"decode",       "spoke",        "preprocess", "guard zone",
+                                                  "true trails",  "rel. trails",  "colour spoke", "draw overlay",
+                                                  "draw panel",   "texture upload"};
+
+void LatencyHistogram::Reset() {
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    m_buckets[i].store(0, std::memory_order_relaxed);
+  }
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetCount() {
+  uint64_t count = 0;
+
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    count += m_buckets[i].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t LatencyHistogram::BucketLimit(size_t bucket) {
+  if (bucket < (1 << LATENCY_SUB_BITS)) {
+    return bucket;
+  }
+  int shift = (int)(bucket >> LATENCY_SUB_BITS) - 1;
+  uint64_t mantissa = (1 << LATENCY_SUB_BITS) | (bucket & ((1 << LATENCY_SUB_BITS) - 1));
+  return ((mantissa + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) {
+  uint64_t counts[LATENCY_BUCKETS];
+  uint64_t total = 0;
+
+  // Take a snapshot first, samples keep coming in while we look
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t wanted = (uint64_t)(percentile / 100. * total + 0.5);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += counts[i];
+    if (seen >= wanted && seen > 0) {
+      return wxMin(BucketLimit(i), GetMax());
+    }
+  }
+  return GetMax();
+}
+
+void LatencyStats::Enable(bool enable) {
+  if (enable && !IsEnabled()) {
+    Reset();
+  }
+  m_enabled.store(enable, std::memory_order_relaxed);
+}
+
+void LatencyStats::Reset() {
+  for (int s = 0; s < LATENCY_STAGES; s++) {
+    m_stage[s].Reset();
+  }
+}
+
+wxString LatencyStats::GetText() {
+  wxString t;
+
+  for (int s = 0; s < LATENCY_STAGES; s++) {
+    LatencyHistogram &h = m_stage[s];
+    if (h.GetCount() > 0) {
+      t << wxString::Format(wxT("%s %.1f/%.1f/%.1f us\n"), stage_names[s], h.GetPercentile(50.) / 1000.,
+                            h.GetPercentile(99.) / 1000., h.GetMax() / 1000.);
+    }
+  }
+  return t;
+}
+
+const char *LatencyStats::GetStageName(LatencyStage stage) { return stage_names[stage]; }
+
+PLUGIN_END_NAMESPACE
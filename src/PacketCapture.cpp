@@ -0,0 +1,103 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "PacketCapture.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+PacketCapture::PacketCapture(radar_pi *pi, size_t packets) {
+  m_pi = pi;
+  m_capacity = 1;
+  while (m_capacity < packets) {
+    m_capacity <<= 1;
+  }
+  m_mask = m_capacity - 1;
+  m_head = 0;
+  m_slots = new Slot[m_capacity];
+  for (size_t i = 0; i < m_capacity; i++) {
+    m_slots[i].seq = 0;
+    m_slots[i].len = 0;
+  }
+}
+
+PacketCapture::~PacketCapture() { delete[] m_slots; }
+
+void PacketCapture::Capture(const uint8_t *data, size_t len) {
+  size_t head = m_head.load(std::memory_order_relaxed);
+  Slot *slot = &m_slots[head & m_mask];
+  uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+
+  slot->seq.store(seq + 1, std::memory_order_relaxed);  // odd: being written
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->len = (uint32_t)len;
+  slot->millis = wxGetUTCTimeMillis();
+  memcpy(slot->data, data, wxMin(len, (size_t)PACKET_CAPTURE_MAX_LEN));
+  slot->seq.store(seq + 2, std::memory_order_release);
+
+  m_head.store(head + 1, std::memory_order_release);
+}
+
+size_t PacketCapture::Dump(const wxString &what) {
+  uint8_t data[PACKET_CAPTURE_MAX_LEN];
+  size_t head = m_head.load(std::memory_order_acquire);
+  size_t first = (head > m_capacity) ? head - m_capacity : 0;
+  size_t dumped = 0;
+
+  LOG_INFO(wxT("%s: last %d of %d captured packets"), what.c_str(), (int)(head - first), (int)head);
+  for (size_t i = first; i < head; i++) {
+    Slot *slot = &m_slots[i & m_mask];
+    uint32_t seq = slot->seq.load(std::memory_order_acquire);
+
+    if (seq & 1) {
+      continue;  // being overwritten right now
+    }
+    uint32_t len = slot->len;
+    wxLongLong millis = slot->millis;
+    size_t copy = wxMin((size_t)len, (size_t)PACKET_CAPTURE_MAX_LEN);
+    memcpy(data, slot->data, copy);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->seq.load(std::memory_order_relaxed) != seq) {
+      continue;  // overwritten while we copied it
+    }
+
+    wxDateTime t(millis);
+    wxString label = wxString::Format(wxT("%s packet %d at %s.%03d"), what.c_str(), (int)(i - first),
+                                      t.FormatISOCombined(' ').c_str(), (int)(millis % 1000).ToLong());
+    if (len > copy) {
+      label += wxString::Format(wxT(" (truncated from %d)"), (int)len);
+    }
+    m_pi->logBinaryData(label, data, (int)copy);
+    dumped++;
+  }
+  return dumped;
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,452 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "PacketRecorder.h"
+
+#include "RadarInfo.h"
+#include "RadarReceive.h"
+#include "SpokeQueue.h"
+
+#ifndef __WXMSW__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+PLUGIN_BEGIN_NAMESPACE
+
+/*
+ * MappedFile
+ */
+
+MappedFile::MappedFile() {
+#ifdef __WXMSW__
+  m_file = INVALID_HANDLE_VALUE;
+  m_mapping = 0;
+#else
+  m_fd = -1;
+#endif
+  m_data = 0;
+  m_size = 0;
+  m_writable = false;
+}
+
+MappedFile::~MappedFile() { Close(m_size); }
+
+bool MappedFile::Create(const wxString &path, size_t size) {
+  m_writable = true;
+#ifdef __WXMSW__
+  m_file = CreateFileW(path.wc_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+  if (m_file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+#else
+  m_fd = open(path.mb_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_fd < 0) {
+    return false;
+  }
+#endif
+  return Resize(size);
+}
+
+bool MappedFile::Open(const wxString &path) {
+  m_writable = false;
+#ifdef __WXMSW__
+  m_file = CreateFileW(path.wc_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#else
+  m_fd = open(path.mb_str(), O_RDONLY);
+#endif
+  return OpenExisting();
+}
+
+bool MappedFile::OpenWritable(const wxString &path) {
+  m_writable = true;
+#ifdef __WXMSW__
+  m_file = CreateFileW(path.wc_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#else
+  m_fd = open(path.mb_str(), O_RDWR);
+#endif
+  return OpenExisting();
+}
+
+bool MappedFile::OpenExisting() {
+#ifdef __WXMSW__
+  if (m_file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_file, &size)) {
+    return false;
+  }
+  m_size = (size_t)size.QuadPart;
+#else
+  if (m_fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(m_fd, &st) < 0) {
+    return false;
+  }
+  m_size = (size_t)st.st_size;
+#endif
+  return Map();
+}
+
+bool MappedFile::Resize(size_t size) {
+  Unmap();
+#ifdef __WXMSW__
+  LARGE_INTEGER li;
+  li.QuadPart = (LONGLONG)size;
+  if (!SetFilePointerEx(m_file, li, 0, FILE_BEGIN) || !SetEndOfFile(m_file)) {
+    return false;
+  }
+#else
+  if (ftruncate(m_fd, (off_t)size) < 0) {
+    return false;
+  }
+#endif
+  m_size = size;
+  return Map();
+}
+
+bool MappedFile::Map() {
+  if (m_size == 0) {
+    return true;  // Nothing to map, empty file
+  }
+#ifdef __WXMSW__
+  m_mapping = CreateFileMapping(m_file, 0, m_writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, 0);
+  if (!m_mapping) {
+    return false;
+  }
+  m_data = (uint8_t *)MapViewOfFile(m_mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, m_size);
+#else
+  void *p = mmap(0, m_size, m_writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_fd, 0);
+  m_data = (p == MAP_FAILED) ? 0 : (uint8_t *)p;
+#endif
+  return m_data != 0;
+}
+
+void MappedFile::Unmap() {
+#ifdef __WXMSW__
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping) {
+    CloseHandle(m_mapping);
+    m_mapping = 0;
+  }
+#else
+  if (m_data) {
+    munmap(m_data, m_size);
+  }
+#endif
+  m_data = 0;
+}
+
+void MappedFile::Close(size_t final_size) {
+#ifdef __WXMSW__
+  if (m_file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+#else
+  if (m_fd < 0) {
+    return;
+  }
+#endif
+  if (m_writable && final_size != m_size) {
+    Resize(final_size);  // Give back the unused part of the last chunk
+  }
+  Unmap();
+#ifdef __WXMSW__
+  CloseHandle(m_file);
+  m_file = INVALID_HANDLE_VALUE;
+#else
+  close(m_fd);
+  m_fd = -1;
+#endif
+  m_size = 0;
+}
+
+/*
+ * Walks the records from the start of a data file up to the first one that is incomplete or zero filled, which is
+ * where a recording that was not closed ends. Returns the offset just beyond the last complete record.
+ */
+static size_t ScanRecords(const uint8_t *data, size_t size, vector<PacketIndexEntry> *index) {
+  size_t offset = sizeof(PacketFileHeader);
+
+  index->clear();
+  while (size - offset >= sizeof(PacketRecordHeader)) {
+    const PacketRecordHeader *record = (const PacketRecordHeader *)(data + offset);
+    if (record->len == 0 || record->len > size - offset - sizeof(PacketRecordHeader)) {
+      break;
+    }
+    size_t next = offset + PACKET_RECORD_ALIGN(sizeof(PacketRecordHeader) + record->len);
+    if (next > size) {
+      break;
+    }
+    PacketIndexEntry entry;
+    entry.offset = offset;
+    entry.millis = record->millis;
+    index->push_back(entry);
+    offset = next;
+  }
+  return offset;
+}
+
+/*
+ * PacketRecorder
+ */
+
+PacketRecorder::PacketRecorder() {
+  m_index = 0;
+  m_used = 0;
+  m_packets = 0;
+  m_failed = false;
+}
+
+PacketRecorder::~PacketRecorder() { Close(); }
+
+bool PacketRecorder::Open(const wxString &path, RadarType radar_type) {
+  m_path = path;
+  if (wxFileExists(path)) {
+    return Continue(radar_type);
+  }
+  if (!m_file.Create(path, RECORD_CHUNK)) {
+    wxLogError(wxT("radar_pi: cannot create packet recording %s"), path.c_str());
+    m_failed = true;
+    return false;
+  }
+  wxString index_path = path + wxT(".idx");
+  m_index = fopen(index_path.mb_str(), "wb");
+  if (!m_index) {
+    wxLogError(wxT("radar_pi: cannot create packet index %s"), index_path.c_str());
+    m_file.Close(0);
+    m_failed = true;
+    return false;
+  }
+
+  PacketFileHeader *header = (PacketFileHeader *)m_file.GetData();
+  memcpy(header->magic, PACKET_FILE_MAGIC, sizeof(header->magic));
+  header->version = PACKET_FILE_VERSION;
+  header->radar_type = (uint32_t)radar_type;
+  header->start_millis = (uint64_t)wxGetUTCTimeMillis().GetValue();
+  m_used = sizeof(PacketFileHeader);
+
+  LOG_INFO(wxT("radar_pi: recording %s packets to %s"), RadarTypeName[radar_type], path.c_str());
+  return true;
+}
+
+bool PacketRecorder::Continue(RadarType radar_type) {
+  if (!m_file.OpenWritable(m_path) || m_file.GetSize() < sizeof(PacketFileHeader)) {
+    wxLogError(wxT("radar_pi: cannot open packet recording %s"), m_path.c_str());
+    m_file.Close(m_file.GetSize());
+    m_failed = true;
+    return false;
+  }
+  const PacketFileHeader *header = (const PacketFileHeader *)m_file.GetData();
+  if (memcmp(header->magic, PACKET_FILE_MAGIC, sizeof(header->magic)) != 0 || header->version != PACKET_FILE_VERSION ||
+      header->radar_type != (uint32_t)radar_type) {
+    wxLogError(wxT("radar_pi: %s is not a %s packet recording, not recording over it"), m_path.c_str(),
+               RadarTypeName[radar_type]);
+    m_file.Close(m_file.GetSize());
+    m_failed = true;
+    return false;
+  }
+
+  // The index may be behind if the plugin crashed, so write it again from the data
+  vector<PacketIndexEntry> index;
+  m_used = ScanRecords(m_file.GetData(), m_file.GetSize(), &index);
+  m_packets = index.size();
+
+  wxString index_path = m_path + wxT(".idx");
+  m_index = fopen(index_path.mb_str(), "wb");
+  if (!m_index) {
+    wxLogError(wxT("radar_pi: cannot create packet index %s"), index_path.c_str());
+    m_file.Close(m_used);
+    m_failed = true;
+    return false;
+  }
+  if (!index.empty()) {
+    fwrite(&index[0], sizeof(PacketIndexEntry), index.size(), m_index);
+  }
+
+  LOG_INFO(wxT("radar_pi: recording %s packets to %s after %d earlier packets"), RadarTypeName[radar_type], m_path.c_str(),
+           (int)m_packets);
+  return true;
+}
+
+void PacketRecorder::Close() {
+  if (m_index) {
+    fclose(m_index);
+    m_index = 0;
+    LOG_INFO(wxT("radar_pi: recorded %d packets (%d bytes) to %s"), (int)m_packets, (int)m_used, m_path.c_str());
+  }
+  m_file.Close(m_used);
+}
+
+void PacketRecorder::Record(PacketChannel channel, const uint8_t *data, size_t len) {
+  if (m_failed || !m_index) {
+    return;
+  }
+
+  size_t needed = PACKET_RECORD_ALIGN(sizeof(PacketRecordHeader) + len);
+  if (m_used + needed > m_file.GetSize()) {
+    if (!m_file.Resize(m_file.GetSize() + RECORD_CHUNK + needed)) {
+      wxLogError(wxT("radar_pi: cannot grow packet recording %s, recording stopped"), m_path.c_str());
+      m_failed = true;
+      return;
+    }
+  }
+
+  PacketIndexEntry entry;
+  entry.offset = m_used;
+  entry.millis = (uint64_t)wxGetUTCTimeMillis().GetValue();
+
+  PacketRecordHeader *record = (PacketRecordHeader *)(m_file.GetData() + m_used);
+  record->millis = entry.millis;
+  record->len = (uint32_t)len;
+  record->channel = (uint16_t)channel;
+  record->reserved = 0;
+  memcpy(record + 1, data, len);
+  m_used += needed;
+  m_packets++;
+
+  fwrite(&entry, sizeof(entry), 1, m_index);
+}
+
+/*
+ * PacketReplay
+ */
+
+PacketReplay::PacketReplay() {
+  m_index = 0;
+  m_packet_count = 0;
+}
+
+PacketReplay::~PacketReplay() {}
+
+bool PacketReplay::Open(const wxString &path, RadarType radar_type) {
+  if (!m_file.Open(path) || m_file.GetSize() < sizeof(PacketFileHeader)) {
+    wxLogError(wxT("radar_pi: cannot open packet recording %s"), path.c_str());
+    return false;
+  }
+  const PacketFileHeader *header = (const PacketFileHeader *)m_file.GetData();
+  if (memcmp(header->magic, PACKET_FILE_MAGIC, sizeof(header->magic)) != 0 || header->version != PACKET_FILE_VERSION) {
+    wxLogError(wxT("radar_pi: %s is not a radar packet recording"), path.c_str());
+    return false;
+  }
+  if (header->radar_type != (uint32_t)radar_type) {
+    wxLogError(wxT("radar_pi: %s contains a %s recording, not %s"), path.c_str(),
+               header->radar_type < RT_MAX ? RadarTypeName[header->radar_type] : wxT("unknown"), RadarTypeName[radar_type]);
+    return false;
+  }
+
+  if (!LoadIndex(path + wxT(".idx"))) {
+    BuildIndex();
+  }
+  LOG_INFO(wxT("radar_pi: replaying %d packets from %s"), (int)m_packet_count, path.c_str());
+  return m_packet_count > 0;
+}
+
+bool PacketReplay::LoadIndex(const wxString &path) {
+  if (!m_index_file.Open(path) || m_index_file.GetSize() == 0 || m_index_file.GetSize() % sizeof(PacketIndexEntry) != 0) {
+    return false;
+  }
+  const PacketIndexEntry *index = (const PacketIndexEntry *)m_index_file.GetData();
+  size_t count = m_index_file.GetSize() / sizeof(PacketIndexEntry);
+
+  // The index is only usable when it describes the complete data file, record after record, as Play() trusts it
+  size_t size = m_file.GetSize();
+  size_t offset = sizeof(PacketFileHeader);
+  for (size_t n = 0; n < count; n++) {
+    if (index[n].offset != offset || size - offset < sizeof(PacketRecordHeader)) {
+      return false;
+    }
+    const PacketRecordHeader *record = (const PacketRecordHeader *)(m_file.GetData() + offset);
+    if (record->len > size - offset - sizeof(PacketRecordHeader)) {
+      return false;
+    }
+    offset += PACKET_RECORD_ALIGN(sizeof(PacketRecordHeader) + record->len);
+    if (offset > size) {
+      return false;
+    }
+  }
+  if (offset != size) {
+    return false;
+  }
+
+  m_index = index;
+  m_packet_count = count;
+  return true;
+}
+
+void PacketReplay::BuildIndex() {
+  ScanRecords(m_file.GetData(), m_file.GetSize(), &m_built_index);
+  m_index = m_built_index.empty() ? 0 : &m_built_index[0];
+  m_packet_count = m_built_index.size();
+  LOG_INFO(wxT("radar_pi: rebuilt packet index, %d packets"), (int)m_packet_count);
+}
+
+void PacketReplay::Play(RadarReceive *receiver, RadarInfo *ri, bool realtime, volatile bool *shutdown) {
+  vector<uint8_t> packet;  // The decoders may modify the packet, the mapping is read-only
+
+  while (!*shutdown) {
+    wxLongLong start = wxGetUTCTimeMillis();
+    uint64_t first_millis = m_index[0].millis;
+
+    for (size_t n = 0; n < m_packet_count && !*shutdown; n++) {
+      const PacketRecordHeader *record = (const PacketRecordHeader *)(m_file.GetData() + m_index[n].offset);
+
+      if (realtime) {
+        int64_t due = (int64_t)(record->millis - first_millis);
+        int64_t elapsed = (wxGetUTCTimeMillis() - start).GetValue();
+        while (due > elapsed && !*shutdown) {
+          wxMilliSleep((unsigned long)wxMin(due - elapsed, (int64_t)100));
+          elapsed = (wxGetUTCTimeMillis() - start).GetValue();
+        }
+      } else if (ri->m_spoke_queue) {
+        // As fast as possible, but don't measure how fast we can drop spokes
+        while (ri->m_spoke_queue->GetDepth() > ri->m_spoke_queue->GetCapacity() / 2 && !*shutdown) {
+          wxMilliSleep(1);
+        }
+      }
+
+      packet.assign((const uint8_t *)(record + 1), (const uint8_t *)(record + 1) + record->len);
+      receiver->ReplayPacket((PacketChannel)record->channel, packet.data(), packet.size());
+    }
+
+    wxLongLong elapsed = wxGetUTCTimeMillis() - start;
+    LOG_INFO(wxT("%s replayed %d packets in %llu ms"), ri->m_name.c_str(), (int)m_packet_count, elapsed);
+  }
+}
+
+PLUGIN_END_NAMESPACE
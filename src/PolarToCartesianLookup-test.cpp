@@ -0,0 +1,164 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "PolarToCartesianLookup.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+// The full table that PolarToCartesianLookup used to store, one row per spoke
+struct ReferenceLookup {
+  size_t spokes;
+  size_t spoke_len;
+  std::vector<Point> xy;
+
+  ReferenceLookup(size_t s, size_t len) : spokes(s), spoke_len(len + 1), xy(s * (len + 1)) {
+    for (size_t arc = 0; arc < spokes; arc++) {
+      float sine = sinf((float)arc * PI * 2 / spokes);
+      float cosine = cosf((float)arc * PI * 2 / spokes);
+      for (size_t radius = 0; radius < spoke_len; radius++) {
+        xy[arc * spoke_len + radius].x = (float)radius * cosine;
+        xy[arc * spoke_len + radius].y = (float)radius * sine;
+      }
+    }
+  }
+
+  Point GetPoint(size_t angle, size_t radius) { return xy[((angle + spokes) % spokes) * spoke_len + radius]; }
+};
+
+static int Compare(size_t spokes, size_t spoke_len) {
+  PolarToCartesianLookup *lookup = PolarToCartesianLookup::Get(spokes, spoke_len);
+  ReferenceLookup reference(spokes, spoke_len);
+  double worst = 0.;
+  size_t int_differences = 0;
+  int ret = 0;
+
+  for (size_t angle = 0; angle < spokes; angle++) {
+    double exact_cos = cos(angle * PI * 2 / spokes);
+    double exact_sin = sin(angle * PI * 2 / spokes);
+
+    for (size_t radius = 0; radius <= spoke_len; radius++) {
+      Point p = lookup->GetPoint(angle, radius);
+      Point q = lookup->GetPoint(angle - spokes, radius);  // angles may be one revolution negative
+      PointInt pi = lookup->GetPointInt(angle, radius);
+      Point r = reference.GetPoint(angle, radius);
+
+      double error = std::max(fabs(p.x - radius * exact_cos), fabs(p.y - radius * exact_sin));
+      worst = std::max(worst, error);
+      if (error > 1e-6 * (radius + 1) || p.x != q.x || p.y != q.y || pi.x != (int16_t)p.x || pi.y != (int16_t)p.y) {
+        if (ret == 0) {
+          cout << "ERROR: " << spokes << " x " << spoke_len << " spoke " << angle << " radius " << radius << " is (" << p.x << ", "
+               << p.y << "), expected (" << radius * exact_cos << ", " << radius * exact_sin << ")\n";
+        }
+        ret = 1;
+      }
+      if (pi.x != (int16_t)r.x || pi.y != (int16_t)r.y) {
+        int_differences++;
+      }
+    }
+  }
+  cout << "INFO: " << spokes << " x " << spoke_len << " uses " << lookup->GetMemoryUsed() / 1024 << " kB, was "
+       << spokes * (spoke_len + 1) * (sizeof(Point) + sizeof(PointInt)) / 1024 << " kB; largest error " << worst << ", "
+       << int_differences << " integer points differ from the old table\n";
+  PolarToCartesianLookup::Release(lookup);
+  return ret;
+}
+
+static double Throughput(size_t spokes, size_t spoke_len) {
+  PolarToCartesianLookup *lookup = PolarToCartesianLookup::Get(spokes, spoke_len);
+  ReferenceLookup reference(spokes, spoke_len);
+  volatile float sink = 0.;
+  float sum = 0.;
+  double seconds[2];
+
+  for (int table = 0; table < 2; table++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 4; pass++) {
+      for (size_t angle = 0; angle < spokes; angle++) {
+        for (size_t radius = 0; radius < spoke_len; radius++) {
+          Point p = table ? reference.GetPoint(angle, radius) : lookup->GetPoint(angle, radius);
+          sum += p.x + p.y;
+        }
+      }
+    }
+    seconds[table] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  sink = sum;
+  (void)sink;
+
+  double points = 4. * spokes * spoke_len;
+  cout << "INFO: " << spokes << " x " << spoke_len << " " << (int)(points / seconds[0] / 1e6) << " M points/s, old table "
+       << (int)(points / seconds[1] / 1e6) << " M points/s\n";
+  PolarToCartesianLookup::Release(lookup);
+  return seconds[0] / seconds[1];
+}
+
+int PolarToCartesianLookupTest() {
+  int ret = 0;
+
+  // Navico and Raymarine, Garmin xHD, Garmin HD, Raymarine Quantum
+  ret |= Compare(2048, 1024);
+  ret |= Compare(1440, 705);
+  ret |= Compare(720, 252);
+  ret |= Compare(250, 252);
+
+  PolarToCartesianLookup *a = PolarToCartesianLookup::Get(2048, 1024);
+  PolarToCartesianLookup *b = PolarToCartesianLookup::Get(2048, 1024);
+  PolarToCartesianLookup *c = PolarToCartesianLookup::Get(2048, 512);
+  if (a != b || a == c || a->GetUsers() != 2 || c->GetUsers() != 1) {
+    cout << "ERROR: radars with the same geometry do not share the lookup\n";
+    ret = 1;
+  }
+  PolarToCartesianLookup::Release(b);
+  if (a->GetUsers() != 1) {
+    cout << "ERROR: Release does not drop the user\n";
+    ret = 1;
+  }
+  PolarToCartesianLookup::Release(a);
+  PolarToCartesianLookup::Release(c);
+
+  Throughput(2048, 1024);
+  Throughput(250, 252);
+
+  if (ret == 0) {
+    cout << "INFO: polar lookup matches direct computation\n";
+  }
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main() { return PLUGIN_NAMESPACE::PolarToCartesianLookupTest(); }
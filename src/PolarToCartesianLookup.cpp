@@ -0,0 +1,160 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "PolarToCartesianLookup.h"
+
+#include "radar_pi.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+static wxCriticalSection s_lookups_lock;  // protects s_lookups and m_users
+static PolarToCartesianLookup *s_lookups = 0;
+
+PolarToCartesianLookup *PolarToCartesianLookup::Get(size_t spokes, size_t spoke_len) {
+  wxCriticalSectionLocker lock(s_lookups_lock);
+
+  for (PolarToCartesianLookup *lookup = s_lookups; lookup; lookup = lookup->m_next) {
+    if (lookup->m_spokes == spokes && lookup->m_spoke_len == spoke_len + 1) {
+      lookup->m_users++;
+      return lookup;
+    }
+  }
+
+  PolarToCartesianLookup *lookup = new PolarToCartesianLookup(spokes, spoke_len);
+  lookup->m_users = 1;
+  lookup->m_next = s_lookups;
+  s_lookups = lookup;
+  return lookup;
+}
+
+void PolarToCartesianLookup::Release(PolarToCartesianLookup *lookup) {
+  if (!lookup) {
+    return;
+  }
+  wxCriticalSectionLocker lock(s_lookups_lock);
+
+  if (--lookup->m_users > 0) {
+    return;
+  }
+  for (PolarToCartesianLookup **p = &s_lookups; *p; p = &(*p)->m_next) {
+    if (*p == lookup) {
+      *p = lookup->m_next;
+      break;
+    }
+  }
+  delete lookup;
+}
+
+PolarToCartesianLookup::PolarToCartesianLookup(size_t spokes, size_t spoke_len) {
+  m_spokes = spokes;
+  m_spoke_mask = ((spokes & (spokes - 1)) == 0) ? spokes - 1 : 0;
+  m_spoke_len = spoke_len + 1;
+  m_users = 0;
+  m_next = 0;
+
+  // With 8-way symmetry spoke a is in quadrant a / quarter, at b = a % quarter spokes into it.
+  // The first half of the quadrant is row b, the second half is row quarter - b with x and y swapped.
+  bool octants = (m_spokes % 8) == 0;
+  size_t quarter = m_spokes / 4;
+  m_rows = octants ? m_spokes / 8 + 1 : m_spokes;
+
+  m_xy = (float *)malloc(sizeof(float) * 2 * m_rows * m_spoke_len);
+  m_map = (SpokeMap *)malloc(sizeof(SpokeMap) * m_spokes);
+
+  if (!m_xy || !m_map) {
+    wxLogError(wxT("Out Of Memory, fatal!"));
+    wxAbort();
+  }
+
+  for (size_t row = 0; row < m_rows; row++) {
+    float cosine = (float)cos((double)row * PI * 2 / m_spokes);
+    float sine = (float)sin((double)row * PI * 2 / m_spokes);
+    float *xy = &m_xy[row * m_spoke_len * 2];
+
+    for (size_t radius = 0; radius < m_spoke_len; radius++) {
+      xy[radius * 2] = (float)radius * cosine;
+      xy[radius * 2 + 1] = (float)radius * sine;
+    }
+  }
+
+  for (size_t a = 0; a < m_spokes; a++) {
+    SpokeMap &m = m_map[a];
+
+    if (!octants) {
+      m.row = (uint32_t)(a * m_spoke_len);
+      m.x = 0;
+      m.sign_x = 1.f;
+      m.sign_y = 1.f;
+      continue;
+    }
+
+    size_t b = a % quarter;
+    size_t row = (b <= quarter / 2) ? b : quarter - b;
+    uint32_t swap = (b <= quarter / 2) ? 0 : 1;
+
+    m.row = (uint32_t)(row * m_spoke_len);
+    switch (a / quarter) {
+      case 0:  // x = cos, y = sin
+        m.x = swap;
+        m.sign_x = 1.f;
+        m.sign_y = 1.f;
+        break;
+      case 1:  // x = -sin, y = cos
+        m.x = 1 - swap;
+        m.sign_x = -1.f;
+        m.sign_y = 1.f;
+        break;
+      case 2:  // x = -cos, y = -sin
+        m.x = swap;
+        m.sign_x = -1.f;
+        m.sign_y = -1.f;
+        break;
+      default:  // x = sin, y = -cos
+        m.x = 1 - swap;
+        m.sign_x = 1.f;
+        m.sign_y = -1.f;
+        break;
+    }
+  }
+  LOG_VERBOSE(wxT("PolarToCartesianLookup %d x %d uses %d rows, %d kB"), (int)m_spokes, (int)m_spoke_len, (int)m_rows,
+              (int)(GetMemoryUsed() / 1024));
+}
+
+PolarToCartesianLookup::~PolarToCartesianLookup() {
+  free(m_xy);
+  free(m_map);
+}
+
+size_t PolarToCartesianLookup::GetMemoryUsed() {
+  return sizeof(*this) + sizeof(float) * 2 * m_rows * m_spoke_len + sizeof(SpokeMap) * m_spokes;
+}
+
+PLUGIN_END_NAMESPACE
@@ -43,6 +43,8 @@ RadarDraw* RadarDraw::make_Draw(RadarInfo* ri, int draw_method) {
       return new RadarDrawVertex(ri);
     case 1:
       return new RadarDrawShader(ri);
+    case 2:
+      return new RadarDrawShader(ri, true);
     default:
       wxLogError(wxT("unsupported draw method %d"), draw_method);
   }
@@ -52,7 +54,7 @@ RadarDraw* RadarDraw::make_Draw(RadarInfo* ri, int draw_method) {
 RadarDraw::~RadarDraw() {}
 
 void RadarDraw::GetDrawingMethods(wxArrayString& methods) {
-  wxString m[] = {_("Vertex Array"), _("Shader")};
+  wxString m[] = {_("Vertex Array"), _("Shader"), _("Shader with polar mesh")};
 
   methods = wxArrayString(ARRAY_SIZE(m), m);
 }
@@ -32,6 +32,7 @@
 #include "RadarDrawShader.h"
 
 #include "RadarInfo.h"
+#include "SpokeResample.h"
 #include "drawutil.h"
 #include "shaderutil.h"
 
@@ -45,6 +46,22 @@ static const char *VertexShaderText =
     "   gl_Position = ftransform(); \n"
     "} \n";
 
+// Polar mesh, see MakeMesh(): when the radar has moved, each spoke's triangle is moved to where the spoke
+// was received. The offsets are in meters, size.x is the full scale of the mesh.
+static const char *VertexShaderMeshText =
+    "uniform vec2 size; \n"
+    "uniform vec2 position; \n"
+    "uniform float scale; \n"
+    "uniform bool moving; \n"
+    "void main() \n"
+    "{ \n"
+    "   vec4 v = gl_Vertex; \n"
+    "   if (moving) \n"
+    "      v.xy += (gl_MultiTexCoord0.zw - position) * scale * size.x; \n"
+    "   gl_TexCoord[0] = gl_MultiTexCoord0; \n"
+    "   gl_Position = gl_ModelViewProjectionMatrix * v; \n"
+    "} \n";
+
 // Convert to rectangular to polar coordinates for radar image in texture
 // No longer used, always use FragmentShaderColorText so we can draw trails.
 #ifdef NEVER
@@ -60,24 +77,83 @@ static const char *FragmentShaderText =
     "} \n";
 #endif
 
-static const char *FragmentShaderColorText =
-    "uniform sampler2D tex2d; \n"
-    "void main() \n"
-    "{ \n"
-    "   float d = length(gl_TexCoord[0].xy);\n"
-    "   if (d >= 1.0) \n"
-    "      discard; \n"
-    "   float a = atan(gl_TexCoord[0].y, gl_TexCoord[0].x) / 6.28318; \n"
-    "   gl_FragColor = texture2D(tex2d, vec2(d, a)); \n"
-    "} \n";
+// The spoke texture holds the BlobColour of each sample, the palette its colour and transparency.
+// Indices can not be interpolated, so with smoothing on the shader does the bilinear filtering of the
+// colours itself: four index and four palette fetches per fragment instead of one of each.
+#define FRAGMENT_SHADER_PALETTE       \
+  "uniform sampler2D tex2d; \n"       \
+  "uniform sampler2D palette; \n"     \
+  "uniform vec2 size; \n"             \
+  "vec4 colour(vec2 t) \n"            \
+  "{ \n"                              \
+  "   float index = texture2D(tex2d, t).x * 255.0; \n" \
+  "   return texture2D(palette, vec2((index + 0.5) / 256.0, 0.5)); \n" \
+  "} \n"
+
+// The end of main(), with d and a the radius and angle in the spoke texture
+#define FRAGMENT_SHADER_NEAREST            \
+  "   gl_FragColor = colour(vec2(d, a)); \n" \
+  "} \n"
+
+#define FRAGMENT_SHADER_FILTER                                                        \
+  "   vec2 p = vec2(d, a) * size - 0.5; \n"                                          \
+  "   vec2 f = fract(p); \n"                                                         \
+  "   vec2 t = (floor(p) + 0.5) / size; \n"                                          \
+  "   vec2 s = 1.0 / size; \n"                                                       \
+  "   gl_FragColor = mix(mix(colour(t), colour(t + vec2(s.x, 0.0)), f.x), \n"        \
+  "                      mix(colour(t + vec2(0.0, s.y)), colour(t + s), f.x), f.y); \n" \
+  "} \n"
+
+// Motion compensation for the square: the offsets texture holds where each spoke was received, see
+// SetOffset(). When the radar has moved, a point q of the image shows the spoke at its bearing as it was seen from there.
+#define FRAGMENT_SHADER_MOTION                                                       \
+  "uniform sampler2D offsets; \n"                                                  \
+  "uniform vec2 position; \n"                                                      \
+  "uniform float scale; \n"                                                        \
+  "uniform bool moving; \n"                                                        \
+  "vec2 received(vec2 q) \n"                                                       \
+  "{ \n"                                                                           \
+  "   vec4 o = texture2D(offsets, vec2(atan(q.y, q.x) / 6.28318, 0.5)) * 255.0; \n" \
+  "   vec2 m = (vec2(o.r * 256.0 + o.g, o.b * 256.0 + o.a) - 32768.0) / 16.0; \n"  \
+  "   return q - (m - position) * scale; \n"                                       \
+  "} \n"
+
+// Square drawn over the whole radar image, converts each fragment to polar coordinates
+#define FRAGMENT_SHADER_SQUARE                                              \
+  FRAGMENT_SHADER_PALETTE FRAGMENT_SHADER_MOTION                            \
+  "void main() \n"                                                          \
+  "{ \n"                                                                    \
+  "   vec2 q = moving ? received(gl_TexCoord[0].xy) : gl_TexCoord[0].xy; \n" \
+  "   float d = length(q);\n"                                               \
+  "   if (d >= 1.0) \n"                                                     \
+  "      discard; \n"                                                       \
+  "   float a = atan(q.y, q.x) / 6.28318; \n"
+
+// Polar mesh, see MakeMesh(): the texture coordinates are the radius and the angle times the radius,
+// so one division gives the angle at any point of a triangle. The motion compensation is done by
+// VertexShaderMeshText, so it costs nothing per fragment.
+#define FRAGMENT_SHADER_MESH                             \
+  FRAGMENT_SHADER_PALETTE                                \
+  "void main() \n"                                       \
+  "{ \n"                                                 \
+  "   float d = gl_TexCoord[0].x; \n"                    \
+  "   float a = gl_TexCoord[0].y / max(d, 0.000001); \n" \
+  "   if (d >= 1.0) \n"                                  \
+  "      discard; \n"
+
+// Indexed by [m_polar_mesh][m_smoothing]
+static const char *FragmentShaderTexts[2][2] = {
+    {FRAGMENT_SHADER_SQUARE FRAGMENT_SHADER_NEAREST, FRAGMENT_SHADER_SQUARE FRAGMENT_SHADER_FILTER},
+    {FRAGMENT_SHADER_MESH FRAGMENT_SHADER_NEAREST, FRAGMENT_SHADER_MESH FRAGMENT_SHADER_FILTER}};
 
 bool RadarDrawShader::Init(size_t spokes, size_t spoke_len_max) {
   wxCriticalSectionLocker lock(m_exclusive);
 
-  m_format = GL_RGBA;
-  m_channels = SHADER_COLOR_CHANNELS;
+  m_format = GL_LUMINANCE;
+  m_channels = 1;
   m_spokes = spokes;
   m_spoke_len_max = spoke_len_max;
+  m_smoothing = m_ri->m_pi->m_settings.shader_smoothing;
 
   if (!CompileShader && !ShadersSupported()) {
     wxLogError(wxT("the OpenGL system of this computer does not support shader m_programs"));
@@ -86,8 +162,8 @@ bool RadarDrawShader::Init(size_t spokes, size_t spoke_len_max) {
 
   Reset();
 
-  if (!CompileShaderText(&m_vertex, GL_VERTEX_SHADER, VertexShaderText) ||
-      !CompileShaderText(&m_fragment, GL_FRAGMENT_SHADER, FragmentShaderColorText)) {
+  if (!CompileShaderText(&m_vertex, GL_VERTEX_SHADER, m_polar_mesh ? VertexShaderMeshText : VertexShaderText) ||
+      !CompileShaderText(&m_fragment, GL_FRAGMENT_SHADER, FragmentShaderTexts[m_polar_mesh][m_smoothing])) {
     wxLogError(wxT("the OpenGL system of this computer failed to compile shader programs"));
     return false;
   }
@@ -98,14 +174,26 @@ bool RadarDrawShader::Init(size_t spokes, size_t spoke_len_max) {
     return false;
   }
 
+  GLfloat size[2] = {(GLfloat)m_spoke_len_max, (GLfloat)m_spokes};
+  UseProgram(m_program);
+  Uniform1i(GetUniformLocation(m_program, "tex2d"), 0);
+  Uniform1i(GetUniformLocation(m_program, "palette"), 1);
+  Uniform1i(GetUniformLocation(m_program, "offsets"), 2);
+  Uniform2fv(GetUniformLocation(m_program, "size"), 1, size);
+  UseProgram(0);
+  m_uniform_position = GetUniformLocation(m_program, "position");
+  m_uniform_scale = GetUniformLocation(m_program, "scale");
+  m_uniform_moving = GetUniformLocation(m_program, "moving");
+
   glGenTextures(1, &m_texture);
   glBindTexture(GL_TEXTURE_2D, m_texture);
 
-  if (m_data) {
-    free(m_data);
+  if (!InitData(spokes, spoke_len_max)) {
+    return false;
   }
-  m_data = (unsigned char *)calloc(SHADER_COLOR_CHANNELS, m_spoke_len_max * m_spokes);
   // Tell the GPU the size of the texture:
+  glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // a row is m_spoke_len_max bytes
   glTexImage2D(/* target          = */ GL_TEXTURE_2D,
                /* level           = */ 0,
                /* internal_format = */ m_format,
@@ -115,13 +203,159 @@ bool RadarDrawShader::Init(size_t spokes, size_t spoke_len_max) {
                /* format          = */ m_format,
                /* type            = */ GL_UNSIGNED_BYTE,
                /* data            = */ m_data);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glPopClientAttrib();
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  memset(m_palette, 0, sizeof(m_palette));
+  glGenTextures(1, &m_palette_texture);
+  glBindTexture(GL_TEXTURE_2D, m_palette_texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SHADER_PALETTE_SIZE, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_palette);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  glGenTextures(1, &m_offset_texture);
+  glBindTexture(GL_TEXTURE_2D, m_offset_texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_spokes, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_offset_data);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  // Two buffers to stream the spokes through, see UploadSpokes()
+  if (VertexBuffersSupported()) {
+    GenBuffers(2, m_pbo);
+    m_pbo_next = 0;
+  }
+
+  if (m_polar_mesh) {
+    return MakeMesh();
+  }
+  return true;
+}
 
+// One triangle per spoke, from the center to the ends of the spoke and the next one. Along the sides
+// the radius and angle are exact; inside, the radius is off by at most 1 - cos(PI / m_spokes) and the
+// angle, as the ratio of two interpolated values, by even less.
+bool RadarDrawShader::MakeMesh() {
+  m_mesh_vertices = m_spokes * 3;
+  m_mesh = (MeshVertex *)malloc(m_mesh_vertices * sizeof(MeshVertex));
+  if (!m_mesh) {
+    wxLogError(wxT("Out of memory"));
+    return false;
+  }
+
+  float fullscale = m_spoke_len_max;
+  MeshVertex *v = m_mesh;
+  for (size_t i = 0; i < m_spokes; i++) {
+    for (size_t j = i; j <= i + 1; j++) {
+      double angle = 2. * PI * j / m_spokes;
+      v[j - i + 1].x = (GLfloat)(cos(angle) * fullscale);
+      v[j - i + 1].y = (GLfloat)(sin(angle) * fullscale);
+      v[j - i + 1].radius = 1.f;
+      v[j - i + 1].angle = (GLfloat)j / m_spokes;  // the last one is 1, not 0, so it does not wrap
+      v[j - i + 1].north = 0.f;
+      v[j - i + 1].east = 0.f;
+    }
+    v[0].x = 0.f;
+    v[0].y = 0.f;
+    v[0].radius = 0.f;
+    v[0].angle = 0.f;
+    v[0].north = 0.f;
+    v[0].east = 0.f;
+    v += 3;
+  }
+
+  if (VertexBuffersSupported()) {
+    GenBuffers(1, &m_mesh_vbo);
+    BindBuffer(GL_ARRAY_BUFFER, m_mesh_vbo);
+    BufferData(GL_ARRAY_BUFFER, m_mesh_vertices * sizeof(MeshVertex), m_mesh, GL_DYNAMIC_DRAW);
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  return true;
+}
+
+void RadarDrawShader::DrawMesh() {
+  const GLvoid *xy = &m_mesh[0].x;
+  const GLvoid *polar = &m_mesh[0].radius;
+
+  if (m_mesh_vbo) {
+    BindBuffer(GL_ARRAY_BUFFER, m_mesh_vbo);
+    xy = (const GLvoid *)offsetof(MeshVertex, x);
+    polar = (const GLvoid *)offsetof(MeshVertex, radius);
+  }
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glVertexPointer(2, GL_FLOAT, sizeof(MeshVertex), xy);
+  glTexCoordPointer(4, GL_FLOAT, sizeof(MeshVertex), polar);
+  glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_mesh_vertices);
+  glPopClientAttrib();
+  if (m_mesh_vbo) {
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+}
+
+// Sets where each spoke was received in the vertices of its triangle, from offsets laid out like
+// m_offset_data.
+void RadarDrawShader::UpdateMeshOffsets(const unsigned char *offsets) {
+  MeshVertex *v = m_mesh;
+  for (size_t i = 0; i < m_spokes; i++) {
+    const unsigned char *o = offsets + i * SHADER_COLOR_CHANNELS;
+    GLfloat north = (GLfloat)(((o[0] << 8 | o[1]) - 32768) / 16.);
+    GLfloat east = (GLfloat)(((o[2] << 8 | o[3]) - 32768) / 16.);
+    for (int j = 0; j < 3; j++, v++) {
+      v->north = north;
+      v->east = east;
+    }
+  }
+  if (m_mesh_vbo) {
+    BindBuffer(GL_ARRAY_BUFFER, m_mesh_vbo);
+    BufferSubData(GL_ARRAY_BUFFER, 0, m_mesh_vertices * sizeof(MeshVertex), m_mesh);
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+}
+
+// The CPU side of Init(), without any GL calls
+bool RadarDrawShader::InitData(size_t spokes, size_t spoke_len_max) {
+  wxCriticalSectionLocker lock(m_exclusive);
+
+  m_spokes = spokes;
+  m_spoke_len_max = spoke_len_max;
+  if (m_data) {
+    free(m_data);
+  }
+  m_data = (unsigned char *)calloc(m_spoke_len_max, m_spokes);  // all BLOB_NONE
   m_start_line = -1;
   m_lines = 0;
 
-  return true;
+  free(m_spoke_pos);
+  free(m_offset_data);
+  free(m_offset_upload);
+  m_spoke_pos = (GeoPosition *)calloc(sizeof(GeoPosition), m_spokes);
+  m_offset_data = (unsigned char *)calloc(SHADER_COLOR_CHANNELS, m_spokes);
+  m_offset_upload = (unsigned char *)calloc(SHADER_COLOR_CHANNELS, m_spokes);
+  m_reference_set = false;
+  m_offsets_dirty = true;
+  m_still_spokes = 0;
+
+  return m_data != 0 && m_spoke_pos != 0 && m_offset_data != 0 && m_offset_upload != 0;
+}
+
+// Stores where the spoke was received in m_offset_data, as north and east from m_reference in 16 bits
+// each, so it is good for SHADER_OFFSET_RANGE meters. Returns false when it is further than that.
+bool RadarDrawShader::SetOffset(size_t spoke) {
+  const GeoPosition &pos = m_spoke_pos[spoke];
+  double north = (pos.lat - m_reference.lat) * 60. * 1852.;
+  double east = (pos.lon - m_reference.lon) * 60. * 1852. * cos(deg2rad(m_reference.lat));
+  bool ok = fabs(north) < SHADER_OFFSET_RANGE && fabs(east) < SHADER_OFFSET_RANGE;
+  int n = (int)(wxMax(-SHADER_OFFSET_RANGE, wxMin(north, SHADER_OFFSET_RANGE)) * 16.) + 32768;
+  int e = (int)(wxMax(-SHADER_OFFSET_RANGE, wxMin(east, SHADER_OFFSET_RANGE)) * 16.) + 32768;
+  unsigned char *o = m_offset_data + spoke * SHADER_COLOR_CHANNELS;
+
+  o[0] = (unsigned char)(n >> 8);
+  o[1] = (unsigned char)n;
+  o[2] = (unsigned char)(e >> 8);
+  o[3] = (unsigned char)e;
+  return ok;
 }
 
 void RadarDrawShader::Reset() {
@@ -141,11 +375,38 @@ void RadarDrawShader::Reset() {
     glDeleteTextures(1, &m_texture);
     m_texture = 0;
   }
+  if (m_palette_texture) {
+    glDeleteTextures(1, &m_palette_texture);
+    m_palette_texture = 0;
+  }
+  if (m_offset_texture) {
+    glDeleteTextures(1, &m_offset_texture);
+    m_offset_texture = 0;
+  }
+  if (m_pbo[0]) {
+    DeleteBuffers(2, m_pbo);
+    m_pbo[0] = 0;
+    m_pbo[1] = 0;
+  }
+  if (m_mesh_vbo) {
+    DeleteBuffers(1, &m_mesh_vbo);
+    m_mesh_vbo = 0;
+  }
+  if (m_mesh) {
+    free(m_mesh);
+    m_mesh = 0;
+  }
 
   if (m_data) {
     free(m_data);
     m_data = 0;
   }
+  free(m_spoke_pos);
+  m_spoke_pos = 0;
+  free(m_offset_data);
+  m_offset_data = 0;
+  free(m_offset_upload);
+  m_offset_upload = 0;
 }
 
 RadarDrawShader::~RadarDrawShader() {
@@ -155,82 +416,220 @@ RadarDrawShader::~RadarDrawShader() {
 }
 
 void RadarDrawShader::DrawRadarOverlayImage(double radar_scale, double panel_rotate) {
-  wxCriticalSectionLocker lock(m_exclusive);
-
-  if (!m_program || !m_texture || !m_data) {
+  // The GL objects are only made and deleted on this thread, m_exclusive is for the data
+  if (!m_program || !m_texture || !m_palette_texture || !m_offset_texture) {
     return;
   }
 
   glPushAttrib(GL_TEXTURE_BIT);
+  glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
   UseProgram(m_program);
 
+  ActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, m_palette_texture);
+  {
+    wxCriticalSectionLocker lock(m_exclusive);
+    UpdatePalette();
+  }
+  ActiveTexture(GL_TEXTURE2);
+  glBindTexture(GL_TEXTURE_2D, m_offset_texture);
+  UpdateMotion();
+  ActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, m_texture);
+  UploadSpokes();
 
-  if (m_start_line > -1) {
-    // Since the last time we have received data from [m_start_line, m_end_line>
-    // so we only need to update the texture for those data lines.
-    if (m_start_line + m_lines > (int)m_spokes) {
-      int end_line = (m_start_line + m_lines) % m_spokes;
-      // if the new data partly wraps past the end of the texture
-      // tell it the two parts separately
-      // First remap [0, m_end_line>
-      glTexSubImage2D(/* target =   */ GL_TEXTURE_2D,
-                      /* level =    */ 0,
-                      /* x-offset = */ 0,
-                      /* y-offset = */ 0,
-                      /* width =    */ m_spoke_len_max,
-                      /* height =   */ end_line,
-                      /* format =   */ m_format,
-                      /* type =     */ GL_UNSIGNED_BYTE,
-                      /* pixels =   */ m_data);
-      // And then remap [m_start_line, m_spokes>
-      glTexSubImage2D(/* target =   */ GL_TEXTURE_2D,
-                      /* level =    */ 0,
-                      /* x-offset = */ 0,
-                      /* y-offset = */ m_start_line,
-                      /* width =    */ m_spoke_len_max,
-                      /* height =   */ m_spokes - m_start_line,
-                      /* format =   */ m_format,
-                      /* type =     */ GL_UNSIGNED_BYTE,
-                      /* pixels =   */ m_data + m_start_line * m_spoke_len_max * m_channels);
-    } else {
-      // Map [m_start_line, m_end_line>
-      glTexSubImage2D(/* target =   */ GL_TEXTURE_2D,
-                      /* level =    */ 0,
-                      /* x-offset = */ 0,
-                      /* y-offset = */ m_start_line,
-                      /* width =    */ m_spoke_len_max,
-                      /* height =   */ m_lines,
-                      /* format =   */ m_format,
-                      /* type =     */ GL_UNSIGNED_BYTE,
-                      /* pixels =   */ m_data + m_start_line * m_spoke_len_max * m_channels);
+  if (m_mesh) {
+    DrawMesh();
+  } else {
+    // We tell the GPU to draw a square from (-512,-512) to (+512,+512).
+    // The shader morphs this into a circle.
+    float fullscale = m_spoke_len_max;
+    glBegin(GL_QUADS);
+    glTexCoord2f(-1, -1);
+    glVertex2f(-fullscale, -fullscale);
+    glTexCoord2f(1, -1);
+    glVertex2f(fullscale, -fullscale);
+    glTexCoord2f(1, 1);
+    glVertex2f(fullscale, fullscale);
+    glTexCoord2f(-1, 1);
+    glVertex2f(-fullscale, fullscale);
+    glEnd();
+  }
+
+  UseProgram(0);
+  glPopClientAttrib();
+  glPopAttrib();
+}
+
+// Sends the lines received since the last draw to the bound texture.
+//
+// With pixel buffer objects, the lines are copied into the next of the two buffers, which was orphaned
+// first so the driver can still be reading the other one; m_exclusive is only held for that copy.
+// glTexSubImage2D then reads from the buffer, so it returns without waiting for the transfer.
+// Without them, the lines are uploaded straight from m_data while holding m_exclusive.
+void RadarDrawShader::UploadSpokes() {
+  unsigned char *mapped = 0;
+  size_t row = m_spoke_len_max * m_channels;
+  int start_line;
+  int lines;
+
+  {
+    wxCriticalSectionLocker lock(m_exclusive);
+    if (m_start_line < 0 || !m_data) {
+      return;  // nothing received since the last draw
     }
+  }
+  LatencyTimer timer(m_ri->m_latency, LATENCY_TEXTURE_UPLOAD);
+
+  if (m_pbo[0]) {
+    BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[m_pbo_next]);
+    m_pbo_next ^= 1;
+    BufferData(GL_PIXEL_UNPACK_BUFFER, m_spokes * row, 0, GL_STREAM_DRAW);
+    mapped = (unsigned char *)MapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (!mapped) {
+      BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+  }
+
+  {
+    wxCriticalSectionLocker lock(m_exclusive);
+
+    start_line = m_start_line;
+    lines = m_lines;
     m_start_line = -1;
     m_lines = 0;
+    if (!m_data || start_line < 0) {
+      start_line = -1;
+    } else if (mapped) {
+      // Same place in the buffer as in m_data, in one or two parts like the upload
+      size_t first = wxMin((size_t)lines, m_spokes - start_line);
+      memcpy(mapped + start_line * row, m_data + start_line * row, first * row);
+      memcpy(mapped, m_data, (lines - first) * row);
+    } else {
+      UploadLines(m_data, start_line, lines);
+    }
   }
 
-  // We tell the GPU to draw a square from (-512,-512) to (+512,+512).
-  // The shader morphs this into a circle.
-  float fullscale = m_spoke_len_max;
-  glBegin(GL_QUADS);
-  glTexCoord2f(-1, -1);
-  glVertex2f(-fullscale, -fullscale);
-  glTexCoord2f(1, -1);
-  glVertex2f(fullscale, -fullscale);
-  glTexCoord2f(1, 1);
-  glVertex2f(fullscale, fullscale);
-  glTexCoord2f(-1, 1);
-  glVertex2f(-fullscale, fullscale);
-  glEnd();
+  if (mapped) {
+    if (!UnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+      // The buffer was lost (screen mode change), send everything on the next draw
+      wxCriticalSectionLocker lock(m_exclusive);
+      m_start_line = 0;
+      m_lines = m_spokes;
+      start_line = -1;
+    }
+    if (start_line >= 0) {
+      UploadLines(0, start_line, lines);  // offsets into the bound buffer
+    }
+    BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+}
 
-  UseProgram(0);
-  glPopAttrib();
+// Uploads [start_line, start_line + lines> of pixels, which is laid out like m_data, to the texture
+void RadarDrawShader::UploadLines(const unsigned char *pixels, int start_line, int lines) {
+  if (start_line + lines > (int)m_spokes) {
+    int end_line = (start_line + lines) % m_spokes;
+    // if the new data partly wraps past the end of the texture
+    // tell it the two parts separately
+    // First remap [0, m_end_line>
+    glTexSubImage2D(/* target =   */ GL_TEXTURE_2D,
+                    /* level =    */ 0,
+                    /* x-offset = */ 0,
+                    /* y-offset = */ 0,
+                    /* width =    */ m_spoke_len_max,
+                    /* height =   */ end_line,
+                    /* format =   */ m_format,
+                    /* type =     */ GL_UNSIGNED_BYTE,
+                    /* pixels =   */ pixels);
+    // And then remap [m_start_line, m_spokes>
+    glTexSubImage2D(/* target =   */ GL_TEXTURE_2D,
+                    /* level =    */ 0,
+                    /* x-offset = */ 0,
+                    /* y-offset = */ start_line,
+                    /* width =    */ m_spoke_len_max,
+                    /* height =   */ m_spokes - start_line,
+                    /* format =   */ m_format,
+                    /* type =     */ GL_UNSIGNED_BYTE,
+                    /* pixels =   */ pixels + start_line * m_spoke_len_max * m_channels);
+  } else {
+    // Map [m_start_line, m_end_line>
+    glTexSubImage2D(/* target =   */ GL_TEXTURE_2D,
+                    /* level =    */ 0,
+                    /* x-offset = */ 0,
+                    /* y-offset = */ start_line,
+                    /* width =    */ m_spoke_len_max,
+                    /* height =   */ lines,
+                    /* format =   */ m_format,
+                    /* type =     */ GL_UNSIGNED_BYTE,
+                    /* pixels =   */ pixels + start_line * m_spoke_len_max * m_channels);
+  }
+}
+
+// Sets where the radar is now for the motion compensation, and sends the spoke offsets when they changed,
+// to the offsets texture or for the mesh into its vertices. While the radar is still and all spokes of the last revolution were received where it is now, the
+// shader does not look at the offsets.
+void RadarDrawShader::UpdateMotion() {
+  GeoPosition radar_pos;
+  bool moving = false;
+  bool upload = false;
+  GLfloat position[2] = {0.f, 0.f};
+  // Not under m_exclusive: the process thread takes RadarInfo::m_exclusive before this one.
+  bool have_pos = m_ri->GetRadarPosition(&radar_pos);
+
+  {
+    wxCriticalSectionLocker lock(m_exclusive);
+
+    if (m_reference_set && m_ri->m_pixels_per_meter > 0. && have_pos) {
+      moving = m_still_spokes < m_spokes || radar_pos.lat != m_last_pos.lat || radar_pos.lon != m_last_pos.lon;
+      position[0] = (GLfloat)((radar_pos.lat - m_reference.lat) * 60. * 1852.);
+      position[1] = (GLfloat)((radar_pos.lon - m_reference.lon) * 60. * 1852. * cos(deg2rad(m_reference.lat)));
+    }
+    if (moving && m_offsets_dirty) {
+      memcpy(m_offset_upload, m_offset_data, m_spokes * SHADER_COLOR_CHANNELS);
+      m_offsets_dirty = false;
+      upload = true;
+    }
+  }
+
+  Uniform1i(m_uniform_moving, moving);
+  if (moving) {
+    // Texture coordinates are in spoke lengths
+    Uniform2fv(m_uniform_position, 1, position);
+    Uniform1f(m_uniform_scale, (GLfloat)(m_ri->m_pixels_per_meter / m_spoke_len_max));
+  }
+  if (upload) {
+    if (m_mesh) {
+      UpdateMeshOffsets(m_offset_upload);
+    } else {
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_spokes, 1, GL_RGBA, GL_UNSIGNED_BYTE, m_offset_upload);
+    }
+  }
+}
+
+// Uploads the palette when the colours or the transparency have changed; the spokes only hold
+// BlobColour, so they stay as they are.
+void RadarDrawShader::UpdatePalette() {
+  GLubyte palette[SHADER_PALETTE_SIZE * SHADER_COLOR_CHANNELS] = {0};
+
+  for (int i = 0; i < BLOB_COLOURS; i++) {
+    GLubyte *p = &palette[i * SHADER_COLOR_CHANNELS];
+    p[0] = m_ri->m_colour_map_rgb[i].Red();
+    p[1] = m_ri->m_colour_map_rgb[i].Green();
+    p[2] = m_ri->m_colour_map_rgb[i].Blue();
+    p[3] = i != BLOB_NONE ? m_alpha : 0;
+  }
+  if (memcmp(palette, m_palette, sizeof(m_palette)) != 0) {
+    memcpy(m_palette, palette, sizeof(m_palette));
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, SHADER_PALETTE_SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE, m_palette);
+  }
 }
 
 void RadarDrawShader::DrawRadarPanelImage(double panel_scale, double panel_rotate) { DrawRadarOverlayImage(1., 0.); }
 
-void RadarDrawShader::ProcessRadarSpoke(int transparency, SpokeBearing angle, uint8_t *data, size_t len, GeoPosition spoke_pos) {
+void RadarDrawShader::ProcessRadarSpoke(int transparency, SpokeBearing angle, const BlobRun *runs, size_t len,
+                                        GeoPosition spoke_pos) {
   GLubyte alpha = 255 * (MAX_OVERLAY_TRANSPARENCY - transparency) / MAX_OVERLAY_TRANSPARENCY;
   wxCriticalSectionLocker lock(m_exclusive);
 
@@ -240,35 +639,55 @@ void RadarDrawShader::ProcessRadarSpoke(int transparency, SpokeBearing angle, ui
   if (m_lines < (int)m_spokes) {
     m_lines++;
   }
+  m_alpha = alpha;  // goes into the palette, for all spokes
 
-  if (m_channels == SHADER_COLOR_CHANNELS) {
-    unsigned char *d = m_data + (angle * m_spoke_len_max) * m_channels;
-    for (size_t r = 0; r < len; r++) {
-      GLubyte strength = data[r];
-      BlobColour colour = m_ri->m_colour_map[strength];
-      d[0] = m_ri->m_colour_map_rgb[colour].Red();
-      d[1] = m_ri->m_colour_map_rgb[colour].Green();
-      d[2] = m_ri->m_colour_map_rgb[colour].Blue();
-      d[3] = colour != BLOB_NONE ? alpha : 0;
-      d += m_channels;
-    }
-    for (size_t r = len; r < m_spoke_len_max; r++) {
-      *d++ = 0;
-      *d++ = 0;
-      *d++ = 0;
-      *d++ = 0;
-    }
+  if (spoke_pos.lat == m_last_pos.lat && spoke_pos.lon == m_last_pos.lon) {
+    m_still_spokes = wxMin(m_still_spokes + 1, m_spokes);
   } else {
-    unsigned char *d = m_data + (angle * m_spoke_len_max);
-    for (size_t r = 0; r < len; r++) {
-      GLubyte strength = data[r];
-      BlobColour colour = m_ri->m_colour_map[strength];
-      *d++ = (m_ri->m_colour_map_rgb[colour].Red() * alpha) >> 8;
+    m_still_spokes = 0;
+    m_last_pos = spoke_pos;
+  }
+  m_spoke_pos[angle] = spoke_pos;
+  if (!m_reference_set) {
+    m_reference = spoke_pos;
+    m_reference_set = true;
+  }
+  if (!SetOffset(angle)) {
+    // Moved too far from the reference, start again from here
+    m_reference = spoke_pos;
+    for (size_t i = 0; i < m_spokes; i++) {
+      SetOffset(i);
     }
-    for (size_t r = len; r < m_spoke_len_max; r++) {
-      *d++ = 0;
+  }
+  m_offsets_dirty = true;
+
+  unsigned char *d = m_data + angle * m_spoke_len_max;
+  memset(d, BLOB_NONE, m_spoke_len_max);
+  for (const BlobRun *run = runs; run->r2; run++) {
+    if (run->r2 <= m_spoke_len_max) {
+      memset(d + run->r1, run->colour, run->r2 - run->r1);
     }
   }
 }
 
+void RadarDrawShader::ResampleSpokes(double zoom, int rotate) {
+  wxCriticalSectionLocker lock(m_exclusive);
+
+  if (!m_data) {
+    return;
+  }
+  size_t stride = m_spoke_len_max * m_channels;
+  for (size_t i = 0; i < m_spokes; i++) {
+    ZoomSpoke(m_data + i * stride, m_spoke_len_max, m_channels, zoom);
+  }
+  RotateSpokes(m_data, m_spokes, stride, rotate);
+  RotateSpokes((uint8_t *)m_spoke_pos, m_spokes, sizeof(GeoPosition), rotate);
+  RotateSpokes(m_offset_data, m_spokes, SHADER_COLOR_CHANNELS, rotate);
+  m_offsets_dirty = true;
+
+  // Upload the whole texture on the next draw
+  m_start_line = 0;
+  m_lines = m_spokes;
+}
+
 PLUGIN_END_NAMESPACE
@@ -47,8 +47,36 @@ bool RadarDrawVertex::Init(size_t spokes, size_t spoke_len_max) {
 
   if (!m_vertices) {
     m_vertices = (VertexLine*)calloc(sizeof(VertexLine), m_spokes);
+    m_batch_first = (GLint*)malloc(sizeof(GLint) * m_spokes);
+    m_batch_count = (GLsizei*)malloc(sizeof(GLsizei) * m_spokes);
+    // Start with the smallest slot for every spoke, the arena grows to what the picture needs
+    m_arena = new VertexArena(sizeof(VertexPoint), MIN_SLOT, BUFFER_SIZE);
+    m_arena->Reserve(m_spokes * MIN_SLOT);
+    m_line_vertices = 0;
+    m_lines_used = 0;
+
+    m_merge = m_ri->m_pi->m_settings.merge_vertex_blobs;
+    if (m_merge) {
+      m_sector_spokes = wxMax(m_spokes / SECTORS, 1);
+      m_sectors = (m_spokes + m_sector_spokes - 1) / m_sector_spokes;
+      m_sector_dirty = (bool*)calloc(sizeof(bool), m_sectors);
+      m_open = (MergeRun*)malloc(sizeof(MergeRun) * MAX_BLOBS_PER_LINE);
+      m_next = (MergeRun*)malloc(sizeof(MergeRun) * MAX_BLOBS_PER_LINE);
+      m_run_arena = new VertexArena(sizeof(VertexRun), MIN_RUN_SLOT, BUFFER_SIZE / VERTEX_PER_QUAD);
+      m_run_arena->Reserve(m_spokes * MIN_RUN_SLOT);
+    }
   }
-  if (!m_vertices) {
+  if (m_merge) {
+    // A chord over n spokes lies r * (1 - cos(n * PI / spokes)) inside the arc at radius r; keep that below 0.5
+    free(m_merge_span);
+    m_merge_span = (uint16_t*)malloc(sizeof(uint16_t) * (m_spoke_len_max + 1));
+    for (size_t r = 0; m_merge_span && r <= m_spoke_len_max; r++) {
+      double n = r > 0 ? acos(1. - 0.5 / r) * m_spokes / PI : (double)m_spokes;
+      m_merge_span[r] = (uint16_t)wxMax(wxMin(ceil(n) - 1., (double)m_sector_spokes), 1.);
+    }
+  }
+  if (!m_vertices || !m_batch_first || !m_batch_count ||
+      (m_merge && (!m_sector_dirty || !m_open || !m_next || !m_merge_span))) {
     if (!m_oom) {
       wxLogError(wxT("Out of memory"));
       m_oom = true;
@@ -61,24 +89,40 @@ bool RadarDrawVertex::Init(size_t spokes, size_t spoke_len_max) {
 
 void RadarDrawVertex::Reset() {
   if (m_vertices) {
-    for (size_t i = 0; i < m_spokes; i++) {
-      if (m_vertices[i].points) {
-        free(m_vertices[i].points);
-      }
-    }
     free(m_vertices);
     m_vertices = 0;
   }
+  if (m_arena) {
+    delete m_arena;
+    m_arena = 0;
+  }
+  if (m_run_arena) {
+    delete m_run_arena;
+    m_run_arena = 0;
+  }
+  free(m_sector_dirty);
+  m_sector_dirty = 0;
+  free(m_open);
+  m_open = 0;
+  free(m_next);
+  m_next = 0;
+  free(m_merge_span);
+  m_merge_span = 0;
+  free(m_batch_first);
+  m_batch_first = 0;
+  free(m_batch_count);
+  m_batch_count = 0;
+  m_vbo_vertices = 0;
 }
 
-#define ADD_VERTEX_POINT(angle, radius, r, g, b, a)                         \
-  {                                                                         \
-    line->points[count].xy = m_ri->m_polar_lookup->GetPoint(angle, radius); \
-    line->points[count].red = r;                                            \
-    line->points[count].green = g;                                          \
-    line->points[count].blue = b;                                           \
-    line->points[count].alpha = a;                                          \
-    count++;                                                                \
+#define ADD_VERTEX_POINT(angle, radius, r, g, b, a)                    \
+  {                                                                    \
+    points[count].xy = m_ri->m_polar_lookup->GetPoint(angle, radius); \
+    points[count].red = r;                                             \
+    points[count].green = g;                                           \
+    points[count].blue = b;                                            \
+    points[count].alpha = a;                                           \
+    count++;                                                           \
   }
 
 void RadarDrawVertex::SetBlob(VertexLine* line, int angle_begin, int angle_end, int r1, int r2, GLubyte red, GLubyte green,
@@ -90,19 +134,17 @@ void RadarDrawVertex::SetBlob(VertexLine* line, int angle_begin, int angle_end,
   int arc2 = angle_end % m_spokes;
   size_t count = line->count;
 
-  if (line->count + VERTEX_PER_QUAD > line->allocated) {
-    const size_t extra = 8 * VERTEX_PER_QUAD;
-    line->points = (VertexPoint*)realloc(line->points, (line->allocated + extra) * sizeof(VertexPoint));
-    line->allocated += extra;
-  }
-
-  if (!line->points) {
-    if (!m_oom) {
-      wxLogError(wxT("Out of memory"));
-      m_oom = true;
+  if (line->count + VERTEX_PER_QUAD > line->slot.size) {
+    // Move to the next slot size, this only mallocs while the arena is still growing
+    if (!m_arena->Resize(&line->slot, line->count, line->count + VERTEX_PER_QUAD)) {
+      if (!m_oom) {
+        wxLogError(wxT("Out of memory"));
+        m_oom = true;
+      }
+      return;
     }
-    return;
   }
+  VertexPoint* points = GetPoints(line);
 
   // First triangle
   ADD_VERTEX_POINT(arc1, r1, red, green, blue, alpha);
@@ -118,68 +160,307 @@ void RadarDrawVertex::SetBlob(VertexLine* line, int angle_begin, int angle_end,
   line->count = count;
 }
 
-void RadarDrawVertex::ProcessRadarSpoke(int transparency, SpokeBearing angle, uint8_t* data, size_t len, GeoPosition spoke_pos) {
+// Adds the blob between r1 and r2 to the spoke at angle, or to its runs when merging
+void RadarDrawVertex::AddBlob(VertexLine* line, int angle, int r1, int r2, GLubyte red, GLubyte green, GLubyte blue,
+                              GLubyte alpha) {
+  if (!m_merge) {
+    SetBlob(line, angle, angle + 1, r1, r2, red, green, blue, alpha);
+    return;
+  }
+  if (r2 == 0) {
+    return;
+  }
+  if (line->run_count + 1 > line->runs.size) {
+    if (!m_run_arena->Resize(&line->runs, line->run_count, line->run_count + 1)) {
+      if (!m_oom) {
+        wxLogError(wxT("Out of memory"));
+        m_oom = true;
+      }
+      return;
+    }
+  }
+  VertexRun* run = &GetRuns(line)[line->run_count++];
+  run->r1 = (uint16_t)r1;
+  run->r2 = (uint16_t)r2;
+  run->red = red;
+  run->green = green;
+  run->blue = blue;
+  run->alpha = alpha;
+}
+
+// Give memory back when the clutter has gone, but not for every small change
+void RadarDrawVertex::CompactLine(VertexLine* line) {
+  if (line->slot.size > MIN_SLOT && line->count * 4 <= line->slot.size) {
+    m_arena->Resize(&line->slot, line->count, line->count * 2);
+  }
+}
+
+void RadarDrawVertex::ProcessRadarSpoke(int transparency, SpokeBearing angle, const BlobRun* runs, size_t len,
+                                        GeoPosition spoke_pos) {
   GLubyte alpha = 255 * (MAX_OVERLAY_TRANSPARENCY - transparency) / MAX_OVERLAY_TRANSPARENCY;
-  BlobColour previous_colour = BLOB_NONE;
-  GLubyte strength = 0;
   time_t now = time(0);
-  uint8_t red, green, blue;
   wxCriticalSectionLocker lock(m_exclusive);
-  int r_begin = 0;
-  int r_end = 0;
 
   if (angle < 0 || angle >= (int)m_spokes || len > m_spoke_len_max || !m_vertices) {
     return;
   }
   VertexLine* line = &m_vertices[angle];
 
-  if (!line->points) {
-    static size_t INITIAL_ALLOCATION = 600;  // Empirically found to be enough for a complicated picture
-    line->allocated = INITIAL_ALLOCATION;
-    m_count += INITIAL_ALLOCATION;
-    line->points = (VertexPoint*)malloc(line->allocated * sizeof(VertexPoint));
-    if (!line->points) {
-      if (!m_oom) {
-        wxLogError(wxT("Out of memory"));
-        m_oom = true;
+  if (m_merge) {
+    // The blobs are built again from the runs before the next draw
+    line->run_count = 0;
+    m_sector_dirty[angle / m_sector_spokes] = true;
+  } else {
+    if (!line->slot.size) {
+      // A new line starts with the slot that fits the average line so far
+      size_t average = m_lines_used ? m_line_vertices / m_lines_used : 0;
+      if (!m_arena->Alloc(average, &line->slot)) {
+        if (!m_oom) {
+          wxLogError(wxT("Out of memory"));
+          m_oom = true;
+        }
+        line->count = 0;
+        return;
       }
-      line->allocated = 0;
-      line->count = 0;
-      return;
+      m_lines_used++;
     }
+    m_line_vertices -= line->count;
+    line->count = 0;
   }
-  line->count = 0;
   line->timeout = now + m_ri->m_pi->m_settings.max_age;
   line->spoke_pos = spoke_pos;
-  for (size_t radius = 0; radius < len; radius++) {
-    strength = data[radius];
-    BlobColour actual_colour = m_ri->m_colour_map[strength];
-
-    if (actual_colour == previous_colour) {
-      // continue with same color, just register it
-      r_end++;
-    } else if (previous_colour == BLOB_NONE && actual_colour != BLOB_NONE) {
-      // blob starts, no display, just register
-      r_begin = radius;
-      r_end = r_begin + 1;
-      previous_colour = actual_colour;  // new color
-    } else if (previous_colour != BLOB_NONE && (previous_colour != actual_colour)) {
-      red = m_ri->m_colour_map_rgb[previous_colour].Red();
-      green = m_ri->m_colour_map_rgb[previous_colour].Green();
-      blue = m_ri->m_colour_map_rgb[previous_colour].Blue();
-      SetBlob(line, angle, angle + 1, r_begin, r_end, red, green, blue, alpha);
-      previous_colour = actual_colour;
-      if (actual_colour != BLOB_NONE) {  // change of color, start new blob
-        r_begin = radius;
-        r_end = r_begin + 1;
+  for (const BlobRun* run = runs; run->r2; run++) {
+    const PixelColour& rgb = m_ri->m_colour_map_rgb[run->colour];
+    AddBlob(line, angle, run->r1, run->r2, rgb.Red(), rgb.Green(), rgb.Blue(), alpha);
+  }
+  if (m_merge) {
+    if (line->runs.size > MIN_RUN_SLOT && line->run_count * 4 <= line->runs.size) {
+      m_run_arena->Resize(&line->runs, line->run_count, line->run_count * 2);
+    }
+    return;
+  }
+  m_line_vertices += line->count;
+  line->dirty = true;
+  CompactLine(line);
+}
+
+void RadarDrawVertex::MergeSectors() {
+  for (size_t s = 0; s < m_sectors; s++) {
+    if (m_sector_dirty[s]) {
+      MergeSector(s);
+      m_sector_dirty[s] = false;
+    }
+  }
+}
+
+// Builds the blobs of the spokes in a sector from their runs. m_open holds the blobs that the previous spoke
+// was part of, sorted by radius like the runs, so each spoke is one pass over both.
+void RadarDrawVertex::MergeSector(size_t sector) {
+  size_t first = sector * m_sector_spokes;
+  size_t end = wxMin(first + m_sector_spokes, m_spokes);
+  size_t open = 0;
+
+  for (size_t i = first; i < end; i++) {
+    m_line_vertices -= m_vertices[i].count;
+    m_vertices[i].count = 0;
+    m_vertices[i].dirty = true;
+  }
+
+  for (size_t i = first; i <= end; i++) {
+    VertexLine* line = (i < end) ? &m_vertices[i] : 0;
+    VertexRun* runs = line ? GetRuns(line) : 0;
+    size_t run_count = line ? line->run_count : 0;
+    bool joins = line && i > first && line->timeout == line[-1].timeout && line->spoke_pos.lat == line[-1].spoke_pos.lat &&
+                 line->spoke_pos.lon == line[-1].spoke_pos.lon;
+    size_t next = 0;
+    size_t o = 0;
+
+    for (size_t r = 0; r < run_count; r++) {
+      while (joins && o < open && m_open[o].run.r1 < runs[r].r1) {
+        SetMergedBlob(m_open[o++], i);
+      }
+      bool continues = joins && o < open && memcmp(&m_open[o].run, &runs[r], sizeof(VertexRun)) == 0;
+      if (continues && i + 1 - m_open[o].begin > m_merge_span[runs[r].r2]) {
+        SetMergedBlob(m_open[o++], i);  // as wide as it may be at this radius, start the next one here
+        continues = false;
+      }
+      if (continues) {
+        m_next[next++] = m_open[o++];  // continues on this spoke
+      } else {
+        m_next[next].run = runs[r];
+        m_next[next].begin = i;
+        next++;
+      }
+    }
+    while (o < open) {
+      SetMergedBlob(m_open[o++], i);
+    }
+    std::swap(m_open, m_next);
+    open = next;
+  }
+
+  for (size_t i = first; i < end; i++) {
+    m_line_vertices += m_vertices[i].count;
+    CompactLine(&m_vertices[i]);
+  }
+}
+
+// The merged blob from blob.begin up to (not including) spoke end is drawn with its first spoke
+void RadarDrawVertex::SetMergedBlob(const MergeRun& blob, size_t end) {
+  SetBlob(&m_vertices[blob.begin], (int)blob.begin, (int)end, blob.run.r1, blob.run.r2, blob.run.red, blob.run.green,
+          blob.run.blue, blob.run.alpha);
+}
+
+// The vertices are already cartesian, so they are scaled and rotated as points. Blobs that move beyond the
+// end of the spoke are dropped, those that cross it are cut off there.
+void RadarDrawVertex::ResampleSpokes(double zoom, int rotate) {
+  wxCriticalSectionLocker lock(m_exclusive);
+
+  if (!m_vertices || m_spokes == 0) {
+    return;
+  }
+  rotate = ((rotate % (int)m_spokes) + (int)m_spokes) % (int)m_spokes;
+  std::rotate(m_vertices, m_vertices + (m_spokes - rotate), m_vertices + m_spokes);
+
+  if (m_merge) {
+    // Only the runs are zoomed, the blobs are built again at their new bearing
+    for (size_t i = 0; i < m_spokes; i++) {
+      VertexLine* line = &m_vertices[i];
+      VertexRun* runs = GetRuns(line);
+      size_t count = 0;
+
+      for (size_t r = 0; r < line->run_count; r++) {
+        int r1 = (int)(runs[r].r1 * zoom);
+        int r2 = wxMin((int)ceil(runs[r].r2 * zoom), (int)m_spoke_len_max);
+        if (r1 >= (int)m_spoke_len_max) {
+          break;
+        }
+        runs[count] = runs[r];
+        runs[count].r1 = (uint16_t)r1;
+        runs[count].r2 = (uint16_t)r2;
+        count++;
       }
+      line->run_count = count;
+    }
+    for (size_t s = 0; s < m_sectors; s++) {
+      m_sector_dirty[s] = true;
     }
+    return;
   }
-  if (previous_colour != BLOB_NONE) {  // Draw final blob
-    red = m_ri->m_colour_map_rgb[previous_colour].Red();
-    green = m_ri->m_colour_map_rgb[previous_colour].Green();
-    blue = m_ri->m_colour_map_rgb[previous_colour].Blue();
-    SetBlob(line, angle, angle + 1, r_begin, r_end, red, green, blue, alpha);
+
+  float c = (float)(zoom * cos(rotate * 2. * PI / m_spokes));
+  float s = (float)(zoom * sin(rotate * 2. * PI / m_spokes));
+  float max_radius = (float)m_spoke_len_max;
+
+  for (size_t i = 0; i < m_spokes; i++) {
+    VertexLine* line = &m_vertices[i];
+    VertexPoint* points = GetPoints(line);
+    size_t count = 0;
+
+    for (size_t q = 0; q + VERTEX_PER_QUAD <= line->count; q += VERTEX_PER_QUAD) {
+      VertexPoint* quad = &points[q];
+
+      for (int v = 0; v < VERTEX_PER_QUAD; v++) {
+        Point p = quad[v].xy;
+        quad[v].xy.x = c * p.x - s * p.y;
+        quad[v].xy.y = s * p.x + c * p.y;
+      }
+      // See SetBlob: vertices 0, 2 and 3 are at r1, 1, 4 and 5 at r2
+      float r1 = sqrtf(quad[0].xy.x * quad[0].xy.x + quad[0].xy.y * quad[0].xy.y);
+      float r2 = sqrtf(quad[1].xy.x * quad[1].xy.x + quad[1].xy.y * quad[1].xy.y);
+      if (r1 >= max_radius) {
+        continue;
+      }
+      if (r2 > max_radius) {
+        float cut = max_radius / r2;
+        quad[1].xy.x *= cut;
+        quad[1].xy.y *= cut;
+        quad[4].xy = quad[1].xy;
+        quad[5].xy.x *= cut;
+        quad[5].xy.y *= cut;
+      }
+      if (count != q) {
+        memmove(&points[count], quad, VERTEX_PER_QUAD * sizeof(VertexPoint));
+      }
+      count += VERTEX_PER_QUAD;
+    }
+    m_line_vertices -= line->count - count;
+    line->count = count;
+    line->dirty = true;
+  }
+}
+
+// Makes m_vbo current with the lines, and points the vertex and color arrays into it.
+// Returns false when there are no buffer objects, then DrawLine() uses the lines in client memory.
+bool RadarDrawVertex::BindVertices() {
+  if (m_merge) {
+    MergeSectors();
+  }
+  if (!m_vbo) {
+    if (!VertexBuffersSupported()) {
+      return false;
+    }
+    GenBuffers(1, &m_vbo);
+    if (!m_vbo) {
+      return false;
+    }
+    m_vbo_vertices = 0;
+  }
+  BindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+  if (m_vbo_vertices != m_arena->GetCapacity() || m_vbo_generation != m_arena->GetGeneration()) {
+    // The arena moved or grew, so the buffer gets its new size and every line is copied again
+    m_vbo_vertices = m_arena->GetCapacity();
+    m_vbo_generation = m_arena->GetGeneration();
+    BufferData(GL_ARRAY_BUFFER, m_vbo_vertices * sizeof(VertexPoint), 0, GL_DYNAMIC_DRAW);
+    for (size_t i = 0; i < m_spokes; i++) {
+      m_vertices[i].dirty = true;
+    }
+    LOG_VERBOSE(wxT("vertex buffer of %d vertices"), (int)m_vbo_vertices);
+  }
+
+  for (size_t i = 0; i < m_spokes; i++) {
+    VertexLine* line = &m_vertices[i];
+    if (line->dirty) {
+      if (line->count) {
+        BufferSubData(GL_ARRAY_BUFFER, line->slot.offset * sizeof(VertexPoint), line->count * sizeof(VertexPoint),
+                      GetPoints(line));
+      }
+      line->dirty = false;
+    }
+  }
+
+  glVertexPointer(2, GL_FLOAT, sizeof(VertexPoint), (const GLvoid*)offsetof(VertexPoint, xy));
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(VertexPoint), (const GLvoid*)offsetof(VertexPoint, red));
+  m_batch_lines = 0;
+  return true;
+}
+
+void RadarDrawVertex::UnbindVertices() {
+  if (m_vbo) {
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+}
+
+// Queues the line for the next FlushLines(), or draws it straight from client memory
+void RadarDrawVertex::DrawLine(VertexLine* line) {
+  if (m_vbo) {
+    m_batch_first[m_batch_lines] = (GLint)line->slot.offset;
+    m_batch_count[m_batch_lines] = (GLsizei)line->count;
+    m_batch_lines++;
+    return;
+  }
+  VertexPoint* points = GetPoints(line);
+  glVertexPointer(2, GL_FLOAT, sizeof(VertexPoint), &points[0].xy);
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(VertexPoint), &points[0].red);
+  glDrawArrays(GL_TRIANGLES, 0, line->count);
+}
+
+// Draws the queued lines, this must be done before the matrix changes
+void RadarDrawVertex::FlushLines() {
+  if (m_batch_lines) {
+    MultiDrawArrays(GL_TRIANGLES, m_batch_first, m_batch_count, (GLsizei)m_batch_lines);
+    m_batch_lines = 0;
   }
 }
 
@@ -199,6 +480,12 @@ void RadarDrawVertex::DrawRadarOverlayImage(double radar_scale, double panel_rot
   {
     wxCriticalSectionLocker lock(m_exclusive);
 
+    if (!m_vertices) {
+      glDisableClientState(GL_VERTEX_ARRAY);
+      glDisableClientState(GL_COLOR_ARRAY);
+      return;
+    }
+    BindVertices();
     glPushMatrix();
     glTranslated(boat_center.x, boat_center.y, 0);
     glRotated(panel_rotate, 0.0, 0.0, 1.0);
@@ -212,17 +499,18 @@ void RadarDrawVertex::DrawRadarOverlayImage(double radar_scale, double panel_rot
         prev_pos = line->spoke_pos;
         GetCanvasPixLL(m_ri->m_pi->m_vp, &boat_center, line->spoke_pos.lat, line->spoke_pos.lon);
         // move display to the location where the spoke was recorded
+        FlushLines();
         glPopMatrix();
         glPushMatrix();
         glTranslated(boat_center.x, boat_center.y, 0);
         glRotated(panel_rotate, 0.0, 0.0, 1.0);
         glScaled(radar_scale, radar_scale, 1.);
       }
-      glVertexPointer(2, GL_FLOAT, sizeof(VertexPoint), &line->points[0].xy);
-      glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(VertexPoint), &line->points[0].red);
-      glDrawArrays(GL_TRIANGLES, 0, line->count);
+      DrawLine(line);
     }
+    FlushLines();
     glPopMatrix();
+    UnbindVertices();
   }
   glDisableClientState(GL_VERTEX_ARRAY);  // disable vertex arrays
   glDisableClientState(GL_COLOR_ARRAY);
@@ -234,11 +522,20 @@ void RadarDrawVertex::DrawRadarPanelImage(double panel_scale, double panel_rotat
   double prev_offset_lat = 0.;
   double prev_offset_lon = 0.;
   GeoPosition radar_pos, line_pos;
+  // Ask for the position before taking m_exclusive: the process thread takes RadarInfo::m_exclusive first
+  // and this lock second, so the other way round would deadlock.
+  bool have_pos = m_ri->GetRadarPosition(&radar_pos);
   glEnableClientState(GL_VERTEX_ARRAY);
   glEnableClientState(GL_COLOR_ARRAY);
   {
     wxCriticalSectionLocker lock(m_exclusive);
 
+    if (!m_vertices) {
+      glDisableClientState(GL_VERTEX_ARRAY);
+      glDisableClientState(GL_COLOR_ARRAY);
+      return;
+    }
+    BindVertices();
     time_t now = time(0);
     glPushMatrix();
     glRotated(panel_rotate, 0.0, 0.0, 1.0);
@@ -253,13 +550,14 @@ void RadarDrawVertex::DrawRadarPanelImage(double panel_scale, double panel_rotat
       // In the scaling used, a translation of 1. corresponds to the distance from center to the edge of the image
       // that is a distance of m_range.GetValue() / m_ri->m_panel_zoom
       // that means, a distance of 1 meter corresponds to a ranslation of m_ri->m_panel_zoom / m_range.GetValue() units
-      if (m_ri->GetRadarPosition(&radar_pos)) {
+      if (have_pos) {
         offset_lat = (line_pos.lat - radar_pos.lat) * 60. * 1852. * m_ri->m_panel_zoom / m_ri->m_range.GetValue();
         offset_lon = (line_pos.lon - radar_pos.lon) * 60. * 1852. * cos(deg2rad(line_pos.lat)) * m_ri->m_panel_zoom /
                      m_ri->m_range.GetValue();
         if (offset_lat != prev_offset_lat || offset_lon != prev_offset_lon) {
           prev_offset_lat = offset_lat;
           prev_offset_lon = offset_lon;
+          FlushLines();
           glPopMatrix();
           glPushMatrix();
           glRotated(panel_rotate, 0.0, 0.0, 1.0);
@@ -267,14 +565,30 @@ void RadarDrawVertex::DrawRadarPanelImage(double panel_scale, double panel_rotat
           glScaled(panel_scale, panel_scale, 1.);
         }
       }
-      glVertexPointer(2, GL_FLOAT, sizeof(VertexPoint), &line->points[0].xy);
-      glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(VertexPoint), &line->points[0].red);
-      glDrawArrays(GL_TRIANGLES, 0, line->count);
+      DrawLine(line);
     }
+    FlushLines();
     glPopMatrix();
+    UnbindVertices();
   }
   glDisableClientState(GL_VERTEX_ARRAY);  // disable vertex arrays
   glDisableClientState(GL_COLOR_ARRAY);
 }
 
+wxString RadarDrawVertex::GetStatistics() {
+  wxCriticalSectionLocker lock(m_exclusive);
+
+  if (!m_arena) {
+    return wxEmptyString;
+  }
+  wxString s = wxString::Format(wxT("%d vertices %d/%d kB peak %d kB"), (int)m_line_vertices,
+                                (int)(m_arena->GetUsed() * sizeof(VertexPoint) / 1024),
+                                (int)(m_arena->GetCapacity() * sizeof(VertexPoint) / 1024),
+                                (int)(m_arena->GetPeak() * sizeof(VertexPoint) / 1024));
+  if (m_run_arena) {
+    s << wxString::Format(wxT(" runs %d kB"), (int)(m_run_arena->GetUsed() * sizeof(VertexRun) / 1024));
+  }
+  return s;
+}
+
 PLUGIN_END_NAMESPACE
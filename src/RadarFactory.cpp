@@ -32,6 +32,7 @@
 #include "RadarFactory.h"
 
 #include "RadarType.h"
+#include "ReplayReceive.h"
 #include "pi_common.h"
 
 PLUGIN_BEGIN_NAMESPACE
@@ -52,6 +53,9 @@ ControlsDialog* RadarFactory::MakeControlsDialog(size_t radarType, int radar) {
 }
 
 RadarReceive* RadarFactory::MakeRadarReceive(size_t radarType, radar_pi* pi, RadarInfo* ri) {
+  if (!pi->m_settings.replay_file.IsEmpty()) {
+    return MakeReplayReceive(radarType, pi, ri);
+  }
   switch (radarType) {
 #define DEFINE_RADAR(t, x, s, l, a, b, c, d) \
   case t:                                    \
@@ -61,6 +65,17 @@ RadarReceive* RadarFactory::MakeRadarReceive(size_t radarType, radar_pi* pi, Rad
   return 0;
 }
 
+// Same as MakeRadarReceive, but the receive thread reads a packet recording instead of the network.
+RadarReceive* RadarFactory::MakeReplayReceive(size_t radarType, radar_pi* pi, RadarInfo* ri) {
+  switch (radarType) {
+#define DEFINE_RADAR(t, x, s, l, a, b, c, d) \
+  case t:                                    \
+    return new Replay##b;
+#include "RadarType.h"
+  };
+  return 0;
+}
+
 RadarControl* RadarFactory::MakeRadarControl(size_t radarType, radar_pi* pi, RadarInfo* ri) {
   switch (radarType) {
 #define DEFINE_RADAR(t, x, s, l, a, b, c, d) \
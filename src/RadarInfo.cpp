@@ -35,11 +35,17 @@
 #include "ControlsDialog.h"
 #include "GuardZone.h"
 #include "MessageBox.h"
+#include "PacketCapture.h"
+#include "PacketRecorder.h"
 #include "RadarCanvas.h"
 #include "RadarDraw.h"
 #include "RadarFactory.h"
 #include "RadarPanel.h"
+#include "RadarProcess.h"
 #include "RadarReceive.h"
+#include "SpokePreprocess.h"
+#include "SpokeQueue.h"
+#include "SpokeResample.h"
 #include "TrailBuffer.h"
 #include "drawutil.h"
 
@@ -62,8 +68,6 @@ RadarInfo::RadarInfo(radar_pi *pi, int radar) {
   m_timed_idle.Update(1, RCS_OFF);
   m_course_index = 0;
   m_old_range = 0;
-  m_dir_lat = 0;
-  m_dir_lon = 0;
   m_pixels_per_meter = 0.;
   m_previous_auto_range_meters = 0;
   m_previous_orientation = ORIENTATION_HEAD_UP;
@@ -103,6 +107,11 @@ RadarInfo::RadarInfo(radar_pi *pi, int radar) {
   }
   m_control = 0;
   m_receive = 0;
+  m_process = 0;
+  m_workers = 0;
+  m_spoke_queue = 0;
+  m_recorder = 0;
+  m_capture = 0;
   m_draw_panel.draw = 0;
   m_draw_overlay.draw = 0;
   m_draw_time_ms = 1000;  // Assume really bad draw time until we actually measure it to prevent fast redraw at start
@@ -159,6 +168,30 @@ void RadarInfo::Shutdown() {
       m_receive = 0;
     }
   }
+  // Only stop processing once nothing is being added to the queue anymore
+  if (m_process) {
+    m_process->Shutdown();
+    m_process->Wait();
+    delete m_process;
+    m_process = 0;
+    LOG_INFO(wxT("%s process thread stopped"), m_name.c_str());
+  }
+  if (m_workers) {
+    delete m_workers;
+    m_workers = 0;
+  }
+  if (m_spoke_queue) {
+    delete m_spoke_queue;
+    m_spoke_queue = 0;
+  }
+  if (m_recorder) {
+    delete m_recorder;
+    m_recorder = 0;
+  }
+  if (m_capture) {
+    delete m_capture;
+    m_capture = 0;
+  }
   if (m_control_dialog) {
     delete m_control_dialog;
     m_control_dialog = 0;
@@ -215,20 +248,17 @@ RadarInfo::~RadarInfo() {
     free(m_history);
   }
   if (m_polar_lookup) {
-    delete m_polar_lookup;
+    PolarToCartesianLookup::Release(m_polar_lookup);
     m_polar_lookup = 0;
   }
 }
 
 /**
- * Initialize the on-screen and receive/transmit items.
- *
- * This is called after the config file has been loaded, so all state is known.
- * It is also called when the user reselects radars, so it needs to be able to be called
- * multiple times.
+ * Initialize everything that ProcessRadarSpoke needs for the current radar type: the history,
+ * the polar lookup, the colour map, ARPA and the trails. Nothing here needs a window, GL context
+ * or network, so the headless benchmark (src/bench) calls this instead of Init().
  */
-bool RadarInfo::Init() {
-  m_verbose = M_SETTINGS.verbose;
+void RadarInfo::InitSpokeProcessing() {
   m_name = RadarTypeName[m_radar_type];
   m_spokes = RadarSpokes[m_radar_type];
   m_spoke_len_max = RadarSpokeLenMax[m_radar_type];
@@ -236,8 +266,29 @@ bool RadarInfo::Init() {
   for (size_t i = 0; i < m_spokes; i++) {
     m_history[i].line = (uint8_t *)calloc(sizeof(uint8_t), m_spoke_len_max);
   }
-  m_polar_lookup = new PolarToCartesianLookup(m_spokes, m_spoke_len_max);
+  // Init() runs again when the radars are reselected. Get the new lookup before releasing the old one, so
+  // that one with the same geometry is kept instead of being built again.
+  PolarToCartesianLookup *old_lookup = m_polar_lookup;
+  m_polar_lookup = PolarToCartesianLookup::Get(m_spokes, m_spoke_len_max);
+  PolarToCartesianLookup::Release(old_lookup);
   ComputeColourMap();
+  if (!m_arpa) {
+    m_arpa = new Arpa(m_pi, this);
+  }
+  m_trails = new TrailBuffer(this, m_spokes, m_spoke_len_max);
+  ComputeTargetTrails();
+}
+
+/**
+ * Initialize the on-screen and receive/transmit items.
+ *
+ * This is called after the config file has been loaded, so all state is known.
+ * It is also called when the user reselects radars, so it needs to be able to be called
+ * multiple times.
+ */
+bool RadarInfo::Init() {
+  m_verbose = M_SETTINGS.verbose;
+  InitSpokeProcessing();
   if (!m_control) {
     m_control = RadarFactory::MakeRadarControl(m_radar_type, m_pi, this);
     // add context menu for control
@@ -264,18 +315,40 @@ bool RadarInfo::Init() {
       return false;
     }
   }
-  if (!m_arpa) {
-    m_arpa = new Arpa(m_pi, this);
-  }
-  m_trails = new TrailBuffer(this, m_spokes, m_spoke_len_max);
-  ComputeTargetTrails();
   UpdateControlState(true);
-  if (!m_receive) {
+  if (!m_spoke_queue) {
+    m_spoke_queue = new SpokeQueue(m_spokes, m_spoke_len_max);
+  }
+  if (!m_workers && M_SETTINGS.process_threads > 0) {
+    m_workers = new SpokeWorkers(this, M_SETTINGS.process_threads, m_spoke_len_max);
+    if (m_workers->GetThreads() == 0) {
+      delete m_workers;
+      m_workers = 0;
+    }
+  }
+  if (!m_process) {
+    m_process = new RadarProcess(m_pi, this, m_spoke_queue);
+    if (m_process->Run() != wxTHREAD_NO_ERROR) {
+      LOG_INFO(wxT("%s unable to start process thread."), m_name.c_str());
+      delete m_process;
+      m_process = 0;
+    }
+  }
+  if (!m_receive && m_process) {
     LOG_RECEIVE(wxT("%s starting receive thread"), m_name.c_str());
     m_receive = RadarFactory::MakeRadarReceive(m_radar_type, m_pi, this);
     if (!m_receive) {
       LOG_INFO(wxT("%s unable to start receive thread."), m_name.c_str());
     } else {
+      if (M_SETTINGS.capture_packets > 0 && !m_capture) {
+        m_capture = new PacketCapture(m_pi, M_SETTINGS.capture_packets);
+      }
+      if (!M_SETTINGS.record_file.IsEmpty() && M_SETTINGS.replay_file.IsEmpty()) {
+        m_recorder = new PacketRecorder();
+        if (m_recorder->Open(GetPacketFile(M_SETTINGS.record_file), m_radar_type)) {
+          m_receive->SetRecorder(m_recorder);
+        }
+      }
       if (m_receive->Run() != wxTHREAD_NO_ERROR) {
         LOG_INFO(wxT("%s unable to start receive thread."), m_name.c_str());
         if (m_receive) {
@@ -400,7 +473,7 @@ void RadarInfo::ComputeColourMap() {
 }
 
 void RadarInfo::ResetSpokes() {
-  uint8_t zap[SPOKE_LEN_MAX];
+  BlobRun zap;  // no runs at all
   GeoPosition pos;
   GetRadarPosition(&pos);
   LOG_VERBOSE(wxT("reset spokes"));
@@ -415,12 +488,12 @@ void RadarInfo::ResetSpokes() {
 
   if (m_draw_panel.draw) {
     for (size_t r = 0; r < m_spokes; r++) {
-      m_draw_panel.draw->ProcessRadarSpoke(0, r, zap, m_spoke_len_max, pos);
+      m_draw_panel.draw->ProcessRadarSpoke(0, r, &zap, m_spoke_len_max, pos);
     }
   }
   if (m_draw_overlay.draw) {
     for (size_t r = 0; r < m_spokes; r++) {
-      m_draw_overlay.draw->ProcessRadarSpoke(0, r, zap, m_spoke_len_max, pos);
+      m_draw_overlay.draw->ProcessRadarSpoke(0, r, &zap, m_spoke_len_max, pos);
     }
   }
 
@@ -430,6 +503,30 @@ void RadarInfo::ResetSpokes() {
   }
 }
 
+/**
+ * Keep the picture over a range or orientation change: scale the history and the spokes of both
+ * draw methods by zoom (new pixels per meter / old), and turn the panel by panel_rotate spokes.
+ * The overlay and the history are always stored by bearing so they never rotate.
+ */
+void RadarInfo::ResampleSpokes(double zoom, int panel_rotate) {
+  LOG_VERBOSE(wxT("resample spokes zoom %g rotate %d"), zoom, panel_rotate);
+
+  if (zoom != 1.) {
+    for (size_t i = 0; i < m_spokes; i++) {
+      ZoomSpoke(m_history[i].line, m_spoke_len_max, 1, zoom);
+    }
+    for (size_t z = 0; z < GUARD_ZONES; z++) {
+      m_guard_zone[z]->ResetBogeys();
+    }
+  }
+  if (m_draw_panel.draw) {
+    m_draw_panel.draw->ResampleSpokes(zoom, panel_rotate);
+  }
+  if (m_draw_overlay.draw && zoom != 1.) {
+    m_draw_overlay.draw->ResampleSpokes(zoom, 0);
+  }
+}
+
 void RadarInfo::CalculateRotationSpeed(SpokeBearing angle) {
   if (m_radar_type == RM_E120) {
     // Nothing, we learn the rotation speed directly from the radar.
@@ -448,8 +545,22 @@ void RadarInfo::CalculateRotationSpeed(SpokeBearing angle) {
 }
 
 /*
- * A spoke of data has been received by the receive thread and it calls this (in
- * the context of the receive thread, so no UI actions can be performed here.)
+ * A spoke of data has been decoded by the receive thread. Hand it over to the
+ * process thread; this does not take m_exclusive so the receive thread never
+ * waits for drawing. If the process thread cannot keep up the spoke is dropped
+ * and counted in the queue statistics.
+ */
+void RadarInfo::QueueRadarSpoke(SpokeBearing angle, SpokeBearing bearing, uint8_t *data, size_t len, int range_meters,
+                                wxLongLong time_rec) {
+  if (m_spoke_queue) {
+    m_spoke_queue->Push(angle, bearing, data, len, range_meters, time_rec);
+  }
+}
+
+/*
+ * A spoke of data has been taken from the spoke queue by the process thread and
+ * it calls this with m_exclusive held (in the context of the process thread, so
+ * no UI actions can be performed here.)
  *
  * @param angle                 Bearing (relative to Boat)  at which the spoke is seen.
  * @param bearing               Bearing (relative to North) at which the spoke is seen.
@@ -461,7 +572,7 @@ void RadarInfo::CalculateRotationSpeed(SpokeBearing angle) {
 void RadarInfo::ProcessRadarSpoke(SpokeBearing angle, SpokeBearing bearing, uint8_t *data, size_t len, int range_meters,
                                   wxLongLong time_rec) {
   int orientation;
-  int i;
+  LatencyTimer spoke_timer(m_latency, LATENCY_SPOKE);
 
   SampleCourse(angle);            // Calculate course as the moving average of m_hdt over one revolution
   CalculateRotationSpeed(angle);  // Find out how fast the radar is rotating
@@ -472,35 +583,39 @@ void RadarInfo::ProcessRadarSpoke(SpokeBearing angle, SpokeBearing bearing, uint
     return;
   }
 
-  for (i = 0; i < m_main_bang_size.GetValue(); i++) {
-    data[i] = 0;
-  }
-  int threshold = m_threshold.GetValue();
-  if (threshold > 0) {
-    threshold = threshold * (255 - BLOB_HISTORY_MAX) / 100 + BLOB_HISTORY_MAX;
-    for (; i < (int)len; i++) {
-      if (data[i] < threshold) {
-        data[i] = 0;
-      }
-    }
-  }
-
   double pixels_per_meter = (len / (double)range_meters) * (1. - (double)m_range_adjustment.GetValue() * 0.001);
 
   if (m_pixels_per_meter != pixels_per_meter) {
     LOG_RECEIVE(wxT(" %s detected spoke range change from %g to %g pixels/m, %d meters"), m_name.c_str(), m_pixels_per_meter,
                 pixels_per_meter, range_meters);
-    m_pixels_per_meter = pixels_per_meter;
-    ResetSpokes();
-    if (m_arpa) {
-      m_arpa->ClearContours();
+    if (m_workers) {
+      m_workers->Wait();  // the lanes still use the old scale and buffers
     }
+    if (m_pixels_per_meter != 0.) {
+      double zoom = pixels_per_meter / m_pixels_per_meter;
+
+      ResampleSpokes(zoom, 0);
+      if (m_arpa) {
+        m_arpa->ZoomContours(zoom);
+      }
+    } else {
+      ResetSpokes();
+      if (m_arpa) {
+        m_arpa->ClearContours();
+      }
+    }
+    m_pixels_per_meter = pixels_per_meter;
   }
 
   orientation = GetOrientation();
   if ((orientation == ORIENTATION_HEAD_UP || m_previous_orientation == ORIENTATION_HEAD_UP) &&
       (orientation != m_previous_orientation)) {
-    ResetSpokes();
+    if (m_workers) {
+      m_workers->Wait();
+    }
+    // The panel goes from spokes by angle to spokes by bearing or back
+    int rotate = bearing - angle;
+    ResampleSpokes(1., orientation == ORIENTATION_HEAD_UP ? -rotate : rotate);
     m_previous_orientation = orientation;
   }
 
@@ -515,52 +630,152 @@ void RadarInfo::ProcessRadarSpoke(SpokeBearing angle, SpokeBearing bearing, uint
   int stabilized_mode = orientation != ORIENTATION_HEAD_UP;
   uint8_t weakest_normal_blob = m_pi->m_settings.threshold_red;
 
-  uint8_t *hist_data = m_history[bearing].line;
-  m_history[bearing].time = time_rec;
-  memset(hist_data, 0, m_spoke_len_max);
-  GetRadarPosition(&m_history[bearing].pos);
-  for (size_t radius = 0; radius < len; radius++) {
-    if (data[radius] >= weakest_normal_blob) {
-      // and add 1 if above threshold and set the left 2 bits, used for ARPA
-      hist_data[radius] = 192;  // this is C0, 1100 0000
-    }
-    if (data[radius] == 255) {  // approaching doppler target
-      // and add 1 if above threshold and set the left 2 bits, used for ARPA
-      hist_data[radius] = 0xE0;  // this is  1110 0000, bit 3 indicates this is an approaching target
-      m_doppler_count++;
-    }
+  // Read the controls once per spoke, not per sample
+  int main_bang = wxMax(m_main_bang_size.GetValue(), 0);
+  int threshold = m_threshold.GetValue();
+  if (threshold > 0) {
+    threshold = threshold * (255 - BLOB_HISTORY_MAX) / 100 + BLOB_HISTORY_MAX;
   }
-
+  bool doppler = m_doppler.GetValue() > 0;
+
+  {
+    LatencyTimer timer(m_latency, LATENCY_PREPROCESS);
+    m_history[bearing].time = time_rec;
+    GetRadarPosition(&m_history[bearing].pos);
+    // Threshold the spoke and set the ARPA bits in the history in one pass
+    m_doppler_count += (int)PreprocessSpoke(data, len, m_history[bearing].line, m_spoke_len_max, (size_t)main_bang,
+                                            (uint8_t)wxMax(threshold, 0), weakest_normal_blob, doppler);
+  }
+
+  SpokeJob serial_job;
+  BlobRun serial_runs[SPOKE_LEN_MAX + 1];
+  SpokeJob *job = m_workers ? m_workers->NewJob() : &serial_job;
+
+  job->angle = angle;
+  job->bearing = bearing;
+  job->panel_angle = stabilized_mode ? bearing : angle;
+  job->len = len;
+  job->trail_len = len;
+  job->pos = m_history[bearing].pos;
+  job->overlay_transparency = M_SETTINGS.overlay_transparency.GetValue();
+  job->overlay_after_trails = M_SETTINGS.trails_on_overlay;
+  job->lanes = SPOKE_LANE(LANE_TRAILS);
   for (size_t z = 0; z < GUARD_ZONES; z++) {
     if (m_guard_zone[z]->m_alarm_on) {
-      m_guard_zone[z]->ProcessSpoke(angle, data, m_history[bearing].line, len);
+      job->lanes |= SPOKE_LANE(LANE_GUARD_ZONE);
     }
   }
+  if (m_draw_overlay.draw) {
+    job->lanes |= SPOKE_LANE(LANE_DRAW_OVERLAY);
+  }
+  if (m_draw_panel.draw) {
+    job->lanes |= SPOKE_LANE(LANE_DRAW_PANEL);
+  }
+  bool extreme_range = m_pi->m_settings.show_extreme_range;
+  if (extreme_range) {
+    job->trail_len--;
+  }
 
-  size_t trail_len = len;
-  if (m_pi->m_settings.show_extreme_range) {
-    data[len - 1] = 255;
-    trail_len--;
+  if (m_workers) {
+    // The queue reuses `data` as soon as we return, and the lanes run concurrently, so each
+    // variant of the spoke that a lane reads or writes gets its own copy.
+    if (job->lanes & SPOKE_LANE(LANE_GUARD_ZONE)) {
+      memcpy(job->raw, data, len);
+    }
+    if (extreme_range) {
+      data[len - 1] = 255;
+    }
+    memcpy(job->shown, data, len);
+    memcpy(job->trailed, data, len);
+    m_workers->Submit(job);
+    return;
   }
 
-  bool draw_trails_on_overlay = M_SETTINGS.trails_on_overlay;
-  if (m_draw_overlay.draw && !draw_trails_on_overlay) {
-    m_draw_overlay.draw->ProcessRadarSpoke(M_SETTINGS.overlay_transparency.GetValue(), bearing, data, len, m_history[bearing].pos);
+  // Same order as the lanes, but everything in place
+  job->raw = data;
+  job->shown = data;
+  job->trailed = data;
+  job->shown_runs = serial_runs;
+  job->trailed_runs = serial_runs;
+  if (job->lanes & SPOKE_LANE(LANE_GUARD_ZONE)) {
+    ConsumeRadarSpoke(LANE_GUARD_ZONE, *job);
   }
-  m_trails->UpdateTrailPosition();
+  if (extreme_range) {
+    data[len - 1] = 255;
+  }
+  if (m_draw_overlay.draw && !job->overlay_after_trails) {
+    ConsumeRadarSpoke(LANE_DRAW_OVERLAY, *job);
+  }
+  ConsumeRadarSpoke(LANE_TRAILS, *job);
+  if (m_draw_overlay.draw && job->overlay_after_trails) {
+    ConsumeRadarSpoke(LANE_DRAW_OVERLAY, *job);
+  }
+  if (m_draw_panel.draw) {
+    ConsumeRadarSpoke(LANE_DRAW_PANEL, *job);
+  }
+}
 
-  // True trails
-  m_trails->UpdateTrueTrails(bearing, data, trail_len);
+/*
+ * Run one consumer of a preprocessed spoke. This is called either from ProcessRadarSpoke or
+ * from one of the SpokeWorkers threads, in both cases while the process thread holds m_exclusive.
+ * The process thread waits for the workers with that lock held, so nothing here may take it:
+ * what a lane needs from RadarInfo under the lock, such as the position, is in the job.
+ */
+void RadarInfo::ConsumeRadarSpoke(SpokeLane lane, const SpokeJob &job) {
+  switch (lane) {
+    case LANE_GUARD_ZONE: {
+      LatencyTimer timer(m_latency, LATENCY_GUARD_ZONE);
+      for (size_t z = 0; z < GUARD_ZONES; z++) {
+        if (m_guard_zone[z]->m_alarm_on) {
+          m_guard_zone[z]->ProcessSpoke(job.angle, job.raw, m_history[job.bearing].line, job.len);
+        }
+      }
+      break;
+    }
 
-  // Relative trails
-  m_trails->UpdateRelativeTrails(angle, data, trail_len);
+    case LANE_TRAILS: {
+      m_trails->UpdateTrailPosition(job.pos);
 
-  if (m_draw_overlay.draw && draw_trails_on_overlay) {
-    m_draw_overlay.draw->ProcessRadarSpoke(M_SETTINGS.overlay_transparency.GetValue(), bearing, data, len, m_history[bearing].pos);
-  }
+      // True trails
+      {
+        LatencyTimer timer(m_latency, LATENCY_TRUE_TRAILS);
+        m_trails->UpdateTrueTrails(job.bearing, job.trailed, job.trail_len);
+      }
 
-  if (m_draw_panel.draw) {
-    m_draw_panel.draw->ProcessRadarSpoke(4, stabilized_mode ? bearing : angle, data, len, m_history[bearing].pos);
+      // Relative trails
+      {
+        LatencyTimer timer(m_latency, LATENCY_RELATIVE_TRAILS);
+        m_trails->UpdateRelativeTrails(job.angle, job.trailed, job.trail_len);
+      }
+
+      // Colour the spoke once for every draw that waits for the trails
+      if ((job.lanes & SPOKE_LANE(LANE_DRAW_PANEL)) ||
+          ((job.lanes & SPOKE_LANE(LANE_DRAW_OVERLAY)) && job.overlay_after_trails)) {
+        LatencyTimer timer(m_latency, LATENCY_COLOUR_SPOKE);
+        ColourSpoke(job.trailed, job.len, m_colour_map, job.trailed_runs);
+      }
+      break;
+    }
+
+    case LANE_DRAW_OVERLAY: {
+      LatencyTimer timer(m_latency, LATENCY_DRAW_OVERLAY);
+      const BlobRun *runs = job.trailed_runs;
+      if (!job.overlay_after_trails) {
+        ColourSpoke(job.shown, job.len, m_colour_map, job.shown_runs);
+        runs = job.shown_runs;
+      }
+      m_draw_overlay.draw->ProcessRadarSpoke(job.overlay_transparency, job.bearing, runs, job.len, job.pos);
+      break;
+    }
+
+    case LANE_DRAW_PANEL: {
+      LatencyTimer timer(m_latency, LATENCY_DRAW_PANEL);
+      m_draw_panel.draw->ProcessRadarSpoke(4, job.panel_angle, job.trailed_runs, job.len, job.pos);
+      break;
+    }
+
+    default:
+      break;
   }
 }
 
@@ -883,7 +1098,25 @@ void RadarInfo::UpdateControlState(bool all) {
   }
 }
 
+/*
+ * Called from the receive thread. The reset goes through the spoke queue, so
+ * the spokes queued before it are not drawn after it, and this thread does not
+ * wait for m_exclusive.
+ */
 void RadarInfo::ResetRadarImage() {
+  if (m_spoke_queue) {
+    m_spoke_queue->PushReset();
+  }
+}
+
+/*
+ * The process thread has reached a reset in the spoke queue, and calls this
+ * with m_exclusive held.
+ */
+void RadarInfo::ProcessRadarReset() {
+  if (m_workers) {
+    m_workers->Wait();  // the lanes may still be drawing the spokes before it
+  }
   ResetSpokes();
   ClearTrails();
   if (m_arpa) {
@@ -903,12 +1136,41 @@ void RadarInfo::RefreshDisplay() {
 }
 
 void RadarInfo::RenderRadarImage2(DrawInfo *di, double radar_scale, double panel_rotate) {
-  wxCriticalSectionLocker lock(m_exclusive);
+  RadarDraw *draw;
+  double panel_scale;
+
+  {
+    wxCriticalSectionLocker lock(m_exclusive);
+    if (!MakeDraw(di)) {
+      return;
+    }
+    draw = di->draw;
+    panel_scale = (m_panel_zoom / m_range.GetValue()) / m_pixels_per_meter;  // typical value 0.001
+  }
+
+  // Only this thread replaces or deletes the draw methods, so they can draw without m_exclusive. They
+  // lock their own data, and the process thread is not kept waiting while the spokes are uploaded.
+  if (di == &m_draw_overlay) {
+    draw->DrawRadarOverlayImage(radar_scale, panel_rotate);
+  } else {
+    draw->DrawRadarPanelImage(panel_scale, panel_rotate);
+  }
+
+  if (g_first_render) {
+    g_first_render = false;
+    wxLongLong startup_elapsed = wxGetUTCTimeMillis() - m_pi->GetBootMillis();
+    LOG_INFO(wxT("First radar image rendered after %llu ms\n"), startup_elapsed);
+  }
+}
+
+// Makes the draw method for di when there is none or the setting changed, called with m_exclusive held.
+// Returns whether there is one to draw with.
+bool RadarInfo::MakeDraw(DrawInfo *di) {
   int drawing_method = m_pi->m_settings.drawing_method;
   int state = m_state.GetValue();
 
   if (state != RADAR_TRANSMIT) {
-    return;
+    return false;
   }
 
   // Determine if a new draw method is required
@@ -916,7 +1178,7 @@ void RadarInfo::RenderRadarImage2(DrawInfo *di, double radar_scale, double panel
     RadarDraw *newDraw = RadarDraw::make_Draw(this, drawing_method);
     if (!newDraw) {
       wxLogError(wxT("out of memory"));
-      return;
+      return false;
     } else if (newDraw->Init(m_spokes, m_spoke_len_max)) {
       wxArrayString methods;
       RadarDraw::GetDrawingMethods(methods);
@@ -935,22 +1197,10 @@ void RadarInfo::RenderRadarImage2(DrawInfo *di, double radar_scale, double panel
       delete newDraw;
     }
     if (!di->draw) {
-      return;
+      return false;
     }
   }
-
-  if (di == &m_draw_overlay) {
-    di->draw->DrawRadarOverlayImage(radar_scale, panel_rotate);
-  } else {
-    double panel_scale = (m_panel_zoom / m_range.GetValue()) / m_pixels_per_meter;  // typical value 0.001
-    di->draw->DrawRadarPanelImage(panel_scale, panel_rotate);
-  }
-
-  if (g_first_render) {
-    g_first_render = false;
-    wxLongLong startup_elapsed = wxGetUTCTimeMillis() - m_pi->GetBootMillis();
-    LOG_INFO(wxT("First radar image rendered after %llu ms\n"), startup_elapsed);
-  }
+  return true;
 }
 
 int RadarInfo::GetOrientation() {
@@ -1436,27 +1686,11 @@ void RadarInfo::ComputeTargetTrails() {
   if (trails_state == RCS_OFF) {
     maxRev = 0;
   }
-  TrailRevolutionsAge revolution;
-  double coloursPerRevolution = 0.;
-  double colour = 0.;
-
-  // Like plotter, continuous trails are all very white (non transparent)
-  if ((trails_state != RCS_OFF) && (target_trails < TRAIL_CONTINUOUS)) {
-    coloursPerRevolution = BLOB_HISTORY_COLOURS / (double)maxRev;
-  }
 
   LOG_VERBOSE(wxT("Target trail value %d = %d revolutions"), target_trails, maxRev);
 
-  // Disperse the BLOB_HISTORY values over 0..maxrev
-  for (revolution = 0; revolution <= TRAIL_MAX_REVOLUTIONS; revolution++) {
-    if (revolution >= 1 && revolution < maxRev) {
-      m_trail_colour[revolution] = (BlobColour)(BLOB_HISTORY_0 + (int)colour);
-      colour += coloursPerRevolution;
-    } else {
-      m_trail_colour[revolution] = BLOB_NONE;
-    }
-    // LOG_VERBOSE(wxT("ComputeTargetTrails rev=%u color=%d"), revolution, m_trail_colour[revolution]);
-  }
+  // Disperse the BLOB_HISTORY values over 0..maxrev. Like plotter, continuous trails are all very white (non transparent)
+  ComputeTrailColours(maxRev, target_trails >= TRAIL_CONTINUOUS, BLOB_HISTORY_0, BLOB_HISTORY_COLOURS, m_trail_colour);
 }
 
 wxString RadarInfo::GetInfoStatus() {
@@ -1466,7 +1700,16 @@ wxString RadarInfo::GetInfoStatus() {
   return _("Uninitialized");
 }
 
+wxString RadarInfo::GetPacketFile(const wxString &path) {
+  wxFileName name(path);
+
+  name.SetName(wxString::Format(wxT("%s-%d"), name.GetName().c_str(), m_radar));
+  return name.GetFullPath();
+}
+
 void RadarInfo::ClearTrails() {
+  wxCriticalSectionLocker lock(m_exclusive);  // the trails lane may be using them
+
   if (m_trails) {
     delete m_trails;
   }
@@ -1578,6 +1821,22 @@ wxString RadarInfo::GetRadarStateText() {
   return o;
 }
 
+// One line per draw method that has something to say, for the statistics box
+wxString RadarInfo::GetDrawStatistics() {
+  wxCriticalSectionLocker lock(m_exclusive);  // the draw methods are replaced while holding this
+  wxString s;
+  wxString panel = m_draw_panel.draw ? m_draw_panel.draw->GetStatistics() : wxString(wxEmptyString);
+  wxString overlay = m_draw_overlay.draw ? m_draw_overlay.draw->GetStatistics() : wxString(wxEmptyString);
+
+  if (!panel.IsEmpty()) {
+    s << wxT("panel ") << panel << wxT("\n");
+  }
+  if (!overlay.IsEmpty()) {
+    s << wxT("overlay ") << overlay << wxT("\n");
+  }
+  return s;
+}
+
 /**
  * See how TimedTransmit is doing.
  *
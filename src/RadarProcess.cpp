@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "RadarProcess.h"
+
+#include "RadarInfo.h"
+#include "SpokeQueue.h"
+#include "SpokeWorkers.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+#define MILLIS_PER_WAIT 250
+#define SPOKES_PER_LOCK 64  // Don't keep the GUI thread waiting for a complete backlog
+
+void *RadarProcess::Entry(void) {
+  LOG_VERBOSE(wxT("%s process thread starting"), m_ri->m_name.c_str());
+  SpokeWorkers::PinToCore(SpokeWorkers::GetFirstCore(m_pi, (int)m_ri->m_radar));
+
+  while (!m_shutdown) {
+    QueuedSpoke *spoke = m_queue->Front();
+    if (!spoke) {
+      m_queue->WaitForData(MILLIS_PER_WAIT);
+      continue;
+    }
+
+    wxCriticalSectionLocker lock(m_ri->m_exclusive);
+
+    for (int n = 0; spoke && n < SPOKES_PER_LOCK; n++) {
+      if (spoke->reset) {
+        m_ri->ProcessRadarReset();
+      } else {
+        m_ri->ProcessRadarSpoke(spoke->angle, spoke->bearing, spoke->data, spoke->len, spoke->range_meters, spoke->time);
+      }
+      m_queue->Pop();
+      spoke = m_queue->Front();
+    }
+    if (m_ri->m_workers) {
+      m_ri->m_workers->Wait();  // The consumers must be done before the GUI can take the lock
+    }
+  }
+
+  LOG_VERBOSE(wxT("%s process thread stopped"), m_ri->m_name.c_str());
+  return 0;
+}
+
+void RadarProcess::Shutdown(void) {
+  m_shutdown = true;
+  m_queue->Wake();
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,164 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "SpokePreprocess.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+#define BLOB_HISTORY_MAX (32)  // as in radar_pi.h
+
+// What RadarInfo::ProcessRadarSpoke did before PreprocessSpoke, in separate loops
+static int PreprocessReference(uint8_t *data, size_t len, uint8_t *hist_data, size_t spoke_len_max, int main_bang,
+                               int threshold, uint8_t weakest_normal_blob) {
+  int doppler_count = 0;
+  int i;
+
+  for (i = 0; i < main_bang; i++) {
+    data[i] = 0;
+  }
+  if (threshold > 0) {
+    threshold = threshold * (255 - BLOB_HISTORY_MAX) / 100 + BLOB_HISTORY_MAX;
+    for (; i < (int)len; i++) {
+      if (data[i] < threshold) {
+        data[i] = 0;
+      }
+    }
+  }
+  memset(hist_data, 0, spoke_len_max);
+  for (size_t radius = 0; radius < len; radius++) {
+    if (data[radius] >= weakest_normal_blob) {
+      hist_data[radius] = 192;
+    }
+    if (data[radius] == 255) {
+      hist_data[radius] = 0xE0;
+      doppler_count++;
+    }
+  }
+  return doppler_count;
+}
+
+static int Compare(size_t len, size_t spoke_len_max, int main_bang, int threshold, uint8_t weakest, bool doppler) {
+  vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = (rand() % 4 == 0) ? 255 : (uint8_t)rand();
+  }
+  vector<uint8_t> ref_data(data);
+  vector<uint8_t> ref_hist(spoke_len_max, 0x55);
+  vector<uint8_t> hist(spoke_len_max, 0xaa);
+
+  int ref_count = PreprocessReference(&ref_data[0], len, &ref_hist[0], spoke_len_max, main_bang, threshold, weakest);
+  int sample_threshold = threshold > 0 ? threshold * (255 - BLOB_HISTORY_MAX) / 100 + BLOB_HISTORY_MAX : 0;
+  int count = (int)PreprocessSpoke(&data[0], len, &hist[0], spoke_len_max, main_bang, (uint8_t)sample_threshold, weakest,
+                                   doppler);
+
+  if (data != ref_data || hist != ref_hist || count != (doppler ? ref_count : 0)) {
+    cout << "ERROR: len " << len << " main bang " << main_bang << " threshold " << threshold << " weakest " << (int)weakest
+         << " doppler " << doppler << " differs, count " << count << " expected " << ref_count << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+// The runs must paint the spoke exactly as the colour map does, and no two runs may be adjacent with the same colour
+static int CompareColours(size_t len) {
+  vector<uint8_t> data(len);
+  uint8_t colour_map[UINT8_MAX + 1];
+  vector<BlobRun> runs(len + 1);
+
+  for (int i = 0; i <= UINT8_MAX; i++) {
+    colour_map[i] = (i < 64) ? 0 : (uint8_t)(i / 64);
+  }
+  for (size_t i = 0; i < len; i++) {
+    data[i] = (rand() % 3 == 0 && i > 0) ? data[i - 1] : (uint8_t)rand();
+  }
+
+  size_t count = ColourSpoke(&data[0], len, colour_map, &runs[0]);
+  vector<uint8_t> painted(len, 0);
+  size_t end = 0;
+  for (size_t i = 0; i < count; i++) {
+    const BlobRun &run = runs[i];
+    if (run.r1 < end || run.r2 <= run.r1 || run.r2 > len || run.colour == 0 ||
+        (i > 0 && run.r1 == runs[i - 1].r2 && run.colour == runs[i - 1].colour)) {
+      cout << "ERROR: len " << len << " run " << i << " " << run.r1 << "-" << run.r2 << " is wrong\n";
+      return 1;
+    }
+    memset(&painted[run.r1], run.colour, run.r2 - run.r1);
+    end = run.r2;
+  }
+  if (runs[count].r2 != 0) {
+    cout << "ERROR: len " << len << " runs do not end\n";
+    return 1;
+  }
+  for (size_t i = 0; i < len; i++) {
+    if (painted[i] != colour_map[data[i]]) {
+      cout << "ERROR: len " << len << " sample " << i << " has colour " << (int)painted[i] << " expected "
+           << (int)colour_map[data[i]] << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int SpokePreprocessTest() {
+  int ret = 0;
+
+  srand(1);
+  for (int i = 0; i < 5000 && ret == 0; i++) {
+    size_t spoke_len_max = 1 + rand() % 1100;
+    size_t len = 1 + rand() % spoke_len_max;
+    int main_bang = rand() % (len + 1);
+    int threshold = (i % 2 == 0) ? 0 : rand() % 101;
+    uint8_t weakest = (i % 7 == 0) ? 0 : (uint8_t)rand();
+
+    ret |= Compare(len, spoke_len_max, main_bang, threshold, weakest, true);
+    ret |= Compare(len, spoke_len_max, main_bang, threshold, weakest, false);
+  }
+
+  if (ret == 0) {
+    cout << "INFO: PreprocessSpoke matches the original loops\n";
+  }
+
+  for (int i = 0; i < 5000 && ret == 0; i++) {
+    ret |= CompareColours(1 + rand() % 1100);
+  }
+  if (ret == 0) {
+    cout << "INFO: ColourSpoke runs match the colour map\n";
+  }
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main() { return PLUGIN_NAMESPACE::SpokePreprocessTest(); }
@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "SpokePreprocess.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+template <bool THRESHOLD, bool DOPPLER>
+static size_t PreprocessKernel(uint8_t *__restrict data, uint8_t *__restrict history, size_t begin, size_t end,
+                               uint8_t threshold, uint8_t weakest_normal_blob) {
+  size_t doppler_count = 0;
+
+  // Count in blocks that cannot overflow a byte, so the count stays in the vector lanes
+  for (size_t block = begin; block < end; block += UINT8_MAX) {
+    size_t block_end = wxMin(block + UINT8_MAX, end);
+    uint8_t count = 0;
+
+    for (size_t i = block; i < block_end; i++) {
+      uint8_t v = data[i];
+      if (THRESHOLD) {
+        v = (v < threshold) ? 0 : v;
+        data[i] = v;
+      }
+      uint8_t is_doppler = (v == UINT8_MAX) ? 1 : 0;
+      history[i] = (uint8_t)(((v >= weakest_normal_blob) ? 0xc0 : 0) | (is_doppler << 5));
+      if (DOPPLER) {
+        count += is_doppler;
+      }
+    }
+    doppler_count += count;
+  }
+  return doppler_count;
+}
+
+size_t PreprocessSpoke(uint8_t *data, size_t len, uint8_t *history, size_t history_len, size_t main_bang, uint8_t threshold,
+                       uint8_t weakest_normal_blob, bool doppler) {
+  len = wxMin(len, history_len);
+  main_bang = wxMin(main_bang, len);
+
+  memset(data, 0, main_bang);
+  memset(history, weakest_normal_blob == 0 ? 0xc0 : 0, main_bang);
+  memset(history + len, 0, history_len - len);
+
+  if (threshold > 0) {
+    if (doppler) {
+      return PreprocessKernel<true, true>(data, history, main_bang, len, threshold, weakest_normal_blob);
+    }
+    return PreprocessKernel<true, false>(data, history, main_bang, len, threshold, weakest_normal_blob);
+  }
+  if (doppler) {
+    return PreprocessKernel<false, true>(data, history, main_bang, len, threshold, weakest_normal_blob);
+  }
+  return PreprocessKernel<false, false>(data, history, main_bang, len, threshold, weakest_normal_blob);
+}
+
+size_t ColourSpoke(const uint8_t *data, size_t len, const uint8_t *colour_map, BlobRun *runs) {
+  size_t count = 0;
+  size_t radius = 0;
+
+  while (radius < len) {
+    uint8_t colour = colour_map[data[radius]];
+    size_t begin = radius;
+
+    for (radius++; radius < len && colour_map[data[radius]] == colour; radius++) {
+    }
+    if (colour != 0) {
+      runs[count].r1 = (uint16_t)begin;
+      runs[count].r2 = (uint16_t)radius;
+      runs[count].colour = colour;
+      count++;
+    }
+  }
+  runs[count].r1 = 0;
+  runs[count].r2 = 0;
+  runs[count].colour = 0;
+  return count;
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,124 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "SpokeQueue.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+SpokeQueue::SpokeQueue(size_t spokes, size_t spoke_len_max) : m_wakeup(0, 0) {
+  // Room for one complete rotation, rounded up so that the index can be masked.
+  m_capacity = 1;
+  while (m_capacity < spokes) {
+    m_capacity <<= 1;
+  }
+  m_mask = m_capacity - 1;
+  m_spoke_len_max = spoke_len_max;
+
+  m_slots = (QueuedSpoke *)calloc(sizeof(QueuedSpoke), m_capacity);
+  m_data = (uint8_t *)calloc(m_spoke_len_max, m_capacity);
+  if (!m_slots || !m_data) {
+    wxLogError(wxT("Out Of Memory, fatal!"));
+    wxAbort();
+  }
+  for (size_t i = 0; i < m_capacity; i++) {
+    m_slots[i].data = m_data + i * m_spoke_len_max;
+  }
+
+  m_head = 0;
+  m_tail = 0;
+  m_high_water = 0;
+  m_dropped = 0;
+  m_waiting = false;
+  m_reset_pending = false;
+}
+
+SpokeQueue::~SpokeQueue() {
+  free(m_slots);
+  free(m_data);
+}
+
+bool SpokeQueue::Push(SpokeBearing angle, SpokeBearing bearing, const uint8_t *data, size_t len, int range_meters,
+                      wxLongLong time) {
+  if (m_reset_pending) {
+    PushReset();
+  }
+  QueuedSpoke *spoke = Reserve();
+  if (!spoke) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  if (len > m_spoke_len_max) {
+    len = m_spoke_len_max;
+  }
+  spoke->angle = angle;
+  spoke->bearing = bearing;
+  spoke->len = len;
+  spoke->range_meters = range_meters;
+  spoke->time = time;
+  spoke->reset = false;
+  memcpy(spoke->data, data, len);
+  Commit();
+  return true;
+}
+
+void SpokeQueue::PushReset() {
+  QueuedSpoke *spoke = Reserve();
+  m_reset_pending = !spoke;
+  if (spoke) {
+    spoke->len = 0;
+    spoke->reset = true;
+    Commit();
+  }
+}
+
+void SpokeQueue::WaitForData(unsigned long timeout_ms) {
+  m_waiting.store(true, std::memory_order_seq_cst);
+  if (Front()) {
+    // Something arrived between the caller's check and setting the flag
+    m_waiting.store(false, std::memory_order_relaxed);
+    return;
+  }
+  m_wakeup.WaitTimeout(timeout_ms);
+  m_waiting.store(false, std::memory_order_relaxed);
+}
+
+void SpokeQueue::GetStatistics(receive_statistics *statistics) {
+  statistics->queue_depth = (int)GetDepth();
+  statistics->queue_high_water = (int)m_high_water.load(std::memory_order_relaxed);
+  statistics->queue_dropped = (int)m_dropped.load(std::memory_order_relaxed);
+}
+
+void SpokeQueue::ResetStatistics() {
+  m_high_water.store(GetDepth(), std::memory_order_relaxed);
+  m_dropped.store(0, std::memory_order_relaxed);
+}
+
+PLUGIN_END_NAMESPACE
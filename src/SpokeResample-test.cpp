@@ -0,0 +1,125 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "SpokeResample.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+#define SPOKES (64)
+#define SPOKE_LEN (100)
+
+// Zoom into a separate spoke, the obvious way
+static std::vector<uint8_t> ZoomReference(const std::vector<uint8_t> &spoke, size_t channels, double zoom) {
+  size_t len = spoke.size() / channels;
+  std::vector<uint8_t> out(spoke.size(), 0);
+
+  for (size_t r = 0; r < len; r++) {
+    size_t from = (size_t)(r / zoom);
+    if (from < len) {
+      memcpy(&out[r * channels], &spoke[from * channels], channels);
+    }
+  }
+  return out;
+}
+
+static int CompareZoom(size_t channels, double zoom) {
+  std::vector<uint8_t> spoke(SPOKE_LEN * channels);
+
+  for (size_t i = 0; i < spoke.size(); i++) {
+    spoke[i] = (uint8_t)(rand() % 256);
+  }
+  std::vector<uint8_t> expected = ZoomReference(spoke, channels, zoom);
+  ZoomSpoke(spoke.data(), SPOKE_LEN, channels, zoom);
+  if (spoke != expected) {
+    cout << "ERROR: zoom " << zoom << " with " << channels << " channels differs from the reference\n";
+    return 1;
+  }
+  return 0;
+}
+
+int SpokeResampleTest() {
+  // Range steps of the radars are between 1/3 and 3 times, and any len / range change
+  static const double zooms[] = {0.25, 1. / 3., 0.5, 0.6667, 0.999, 1., 1.001, 1.5, 2., 3., 4.};
+  int ret = 0;
+
+  for (size_t i = 0; i < sizeof(zooms) / sizeof(zooms[0]); i++) {
+    ret |= CompareZoom(1, zooms[i]);
+    ret |= CompareZoom(4, zooms[i]);
+  }
+
+  // A target at 40 pixels is at 80 after zooming in 2 times, and back at 40 after zooming out
+  uint8_t spoke[SPOKE_LEN] = {0};
+  spoke[40] = 200;
+  ZoomSpoke(spoke, SPOKE_LEN, 1, 2.);
+  if (spoke[80] != 200 || spoke[81] != 200 || spoke[79] != 0) {
+    cout << "ERROR: zoom in does not move the target out\n";
+    ret = 1;
+  }
+  ZoomSpoke(spoke, SPOKE_LEN, 1, 0.5);
+  for (size_t r = 0; r < SPOKE_LEN; r++) {
+    if (spoke[r] != (r == 40 ? 200 : 0)) {
+      cout << "ERROR: zoom out does not move the target back\n";
+      ret = 1;
+      break;
+    }
+  }
+
+  // Every spoke i moves to i + rotate
+  const size_t stride = 3;
+  uint8_t image[SPOKES * stride];
+  for (int rotate : {0, 1, 17, -5, SPOKES, -SPOKES - 3}) {
+    for (size_t i = 0; i < SPOKES * stride; i++) {
+      image[i] = (uint8_t)(i / stride);
+    }
+    RotateSpokes(image, SPOKES, stride, rotate);
+    for (size_t i = 0; i < SPOKES; i++) {
+      size_t from = (size_t)(((int)i - rotate % SPOKES + 2 * SPOKES) % SPOKES);
+      if (image[i * stride] != from || image[i * stride + stride - 1] != from) {
+        cout << "ERROR: rotate " << rotate << " puts spoke " << (int)image[i * stride] << " at " << i << "\n";
+        ret = 1;
+        break;
+      }
+    }
+  }
+
+  if (ret == 0) {
+    cout << "INFO: spokes zoom and rotate in place\n";
+  }
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main() { return PLUGIN_NAMESPACE::SpokeResampleTest(); }
@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "SpokeResample.h"
+
+#include <algorithm>
+
+PLUGIN_BEGIN_NAMESPACE
+
+void ZoomSpoke(uint8_t *spoke, size_t len, size_t channels, double zoom) {
+  if (zoom == 1.) {
+    return;
+  }
+  if (zoom > 1.) {
+    // Zoom in: samples move out, so fill from the end and each source is read before it is overwritten
+    for (size_t r = len; r-- > 0;) {
+      size_t from = (size_t)(r / zoom);
+      if (from != r) {
+        memcpy(spoke + r * channels, spoke + from * channels, channels);
+      }
+    }
+    return;
+  }
+  // Zoom out: samples move in, fill from the start
+  size_t r = 0;
+  for (; r < len; r++) {
+    size_t from = (size_t)(r / zoom);
+    if (from >= len) {
+      break;
+    }
+    if (from != r) {
+      memcpy(spoke + r * channels, spoke + from * channels, channels);
+    }
+  }
+  memset(spoke + r * channels, 0, (len - r) * channels);
+}
+
+void RotateSpokes(uint8_t *image, size_t spokes, size_t stride, int rotate) {
+  if (spokes == 0) {
+    return;
+  }
+  size_t k = (size_t)(((rotate % (int)spokes) + (int)spokes) % (int)spokes);
+  if (k == 0) {
+    return;
+  }
+  std::rotate(image, image + (spokes - k) * stride, image + spokes * stride);
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,239 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "SpokeWorkers.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "RadarInfo.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+class SpokeWorker : public wxThread {
+ public:
+  SpokeWorker(SpokeWorkers *workers, int index) : wxThread(wxTHREAD_JOINABLE) {
+    Create(1024 * 1024);
+    m_workers = workers;
+    m_index = index;
+  }
+
+  void *Entry(void) { return m_workers->Run(m_index); }
+
+ private:
+  SpokeWorkers *m_workers;
+  int m_index;
+};
+
+SpokeWorkers::SpokeWorkers(RadarInfo *ri, int threads, size_t spoke_len_max) : m_changed(m_mutex) {
+  m_ri = ri;
+  m_thread_count = 0;
+  m_first_core = GetFirstCore(ri->m_pi, (int)ri->m_radar);
+  m_submitted = 0;
+  m_shutdown = false;
+  for (int l = 0; l < SPOKE_LANES; l++) {
+    m_next[l] = 0;
+    m_busy[l] = false;
+  }
+
+  m_buffers = (uint8_t *)calloc(SPOKE_JOBS * 3, spoke_len_max);
+  if (!m_buffers) {
+    wxLogError(wxT("Out Of Memory, fatal!"));
+    wxAbort();
+  }
+  m_runs = (BlobRun *)calloc(SPOKE_JOBS * 2 * (spoke_len_max + 1), sizeof(BlobRun));
+  if (!m_runs) {
+    wxLogError(wxT("Out Of Memory, fatal!"));
+    wxAbort();
+  }
+  for (size_t j = 0; j < SPOKE_JOBS; j++) {
+    m_jobs[j].raw = m_buffers + j * 3 * spoke_len_max;
+    m_jobs[j].shown = m_jobs[j].raw + spoke_len_max;
+    m_jobs[j].trailed = m_jobs[j].shown + spoke_len_max;
+    m_jobs[j].shown_runs = m_runs + j * 2 * (spoke_len_max + 1);
+    m_jobs[j].trailed_runs = m_jobs[j].shown_runs + spoke_len_max + 1;
+  }
+
+  m_threads = new SpokeWorker *[threads];
+  for (int i = 0; i < threads; i++) {
+    SpokeWorker *thread = new SpokeWorker(this, i);
+    if (thread->Run() != wxTHREAD_NO_ERROR) {
+      LOG_INFO(wxT("%s unable to start spoke worker %d"), ri->m_name.c_str(), i);
+      delete thread;
+      break;
+    }
+    m_threads[m_thread_count++] = thread;
+  }
+  LOG_VERBOSE(wxT("%s started %d spoke workers"), ri->m_name.c_str(), m_thread_count);
+}
+
+SpokeWorkers::~SpokeWorkers() {
+  {
+    wxMutexLocker lock(m_mutex);
+    m_shutdown = true;
+    m_changed.Broadcast();
+  }
+  for (int i = 0; i < m_thread_count; i++) {
+    m_threads[i]->Wait();
+    delete m_threads[i];
+  }
+  delete[] m_threads;
+  free(m_buffers);
+  free(m_runs);
+}
+
+int SpokeWorkers::GetFirstCore(radar_pi *pi, int radar) {
+  if (!pi->m_settings.pin_process_threads) {
+    return -1;
+  }
+  // The process thread plus its workers, each radar gets the next block of cores
+  return radar * (pi->m_settings.process_threads + 1);
+}
+
+void SpokeWorkers::PinToCore(int core) {
+  if (core < 0) {
+    return;
+  }
+  core %= wxMax(wxThread::GetCPUCount(), 1);
+#ifdef __linux__
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    LOG_INFO(wxT("cannot pin thread to core %d"), core);
+  }
+#else
+  LOG_VERBOSE(wxT("pinning threads to cores is not supported on this platform"));
+#endif
+}
+
+SpokeJob *SpokeWorkers::NewJob() {
+  wxMutexLocker lock(m_mutex);
+
+  // The slot is free when all lanes are done with the job that used it before
+  for (;;) {
+    size_t oldest = m_submitted;
+    for (int l = 0; l < SPOKE_LANES; l++) {
+      oldest = wxMin(oldest, m_next[l]);
+    }
+    if (m_submitted - oldest < SPOKE_JOBS) {
+      break;
+    }
+    m_changed.Wait();
+  }
+  return &m_jobs[m_submitted % SPOKE_JOBS];
+}
+
+void SpokeWorkers::Submit(SpokeJob *job) {
+  wxMutexLocker lock(m_mutex);
+
+  m_submitted++;
+  m_changed.Broadcast();
+}
+
+bool SpokeWorkers::IsIdle() {
+  for (int l = 0; l < SPOKE_LANES; l++) {
+    if (m_busy[l] || m_next[l] < m_submitted) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SpokeWorkers::Wait() {
+  wxMutexLocker lock(m_mutex);
+
+  while (!IsIdle()) {
+    m_changed.Wait();
+  }
+}
+
+// Called with m_mutex held. Skips jobs that a lane has nothing to do for.
+bool SpokeWorkers::NextTask(int *lane, SpokeJob **job) {
+  bool skipped = false;
+
+  for (int l = 0; l < SPOKE_LANES; l++) {
+    while (!m_busy[l] && m_next[l] < m_submitted) {
+      SpokeJob *j = &m_jobs[m_next[l] % SPOKE_JOBS];
+
+      if (!(j->lanes & SPOKE_LANE(l))) {
+        m_next[l]++;
+        skipped = true;
+        continue;
+      }
+      bool needs_trails = l == LANE_DRAW_PANEL || (l == LANE_DRAW_OVERLAY && j->overlay_after_trails);
+      if (needs_trails && m_next[LANE_TRAILS] <= m_next[l]) {
+        break;
+      }
+      m_busy[l] = true;
+      *lane = l;
+      *job = j;
+      if (skipped) {
+        m_changed.Broadcast();
+      }
+      return true;
+    }
+  }
+  if (skipped) {
+    m_changed.Broadcast();
+  }
+  return false;
+}
+
+void *SpokeWorkers::Run(int index) {
+  if (m_first_core >= 0) {
+    PinToCore(m_first_core + 1 + index);
+  }
+
+  wxMutexLocker lock(m_mutex);
+
+  while (!m_shutdown) {
+    int lane;
+    SpokeJob *job;
+
+    if (!NextTask(&lane, &job)) {
+      m_changed.Wait();
+      continue;
+    }
+    m_mutex.Unlock();
+    m_ri->ConsumeRadarSpoke((SpokeLane)lane, *job);
+    m_mutex.Lock();
+    m_busy[lane] = false;
+    m_next[lane]++;
+    m_changed.Broadcast();
+  }
+  return 0;
+}
+
+PLUGIN_END_NAMESPACE
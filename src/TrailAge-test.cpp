@@ -0,0 +1,367 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include <zlib.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "NavicoCommon.h"
+#include "NavicoExpand.h"
+#include "TrailSpoke.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+#define SPOKES (64)
+#define SPOKE_LEN (48)
+#define WEAK_TARGET (50)
+#define STRONG_TARGET (200)
+
+// Colour per age for one trail length preset, as RadarInfo::ComputeTargetTrails makes them
+static void TrailColours(int maxRev, uint8_t *colour) {
+  ComputeTrailColours(maxRev, maxRev > TRAIL_MAX_REVOLUTIONS, 100, 32, colour);
+}
+
+// The colours as ComputeTargetTrails made them before
+static int CompareColours(int maxRev) {
+  bool continuous = maxRev > TRAIL_MAX_REVOLUTIONS;
+  double colours_per_revolution = continuous ? 0. : 32. / maxRev;
+  double c = 0.;
+  uint8_t colour[TRAIL_MAX_REVOLUTIONS + 1];
+
+  TrailColours(maxRev, colour);
+  for (int revolution = 0; revolution <= TRAIL_MAX_REVOLUTIONS; revolution++) {
+    uint8_t expected = 0;
+    if (revolution >= 1 && revolution < maxRev) {
+      expected = (uint8_t)(100 + (int)c);
+      c += colours_per_revolution;
+    }
+    if (colour[revolution] != expected) {
+      cout << "ERROR: trail length " << maxRev << " age " << revolution << " has colour " << (int)colour[revolution]
+           << " expected " << (int)expected << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// TrailBuffer::UpdateRelativeTrails as it was, incrementing every age on every sweep
+static void ReferenceTrails(TrailRevolutionsAge *trail, size_t spoke_len, uint8_t *data, size_t len, const uint8_t *colour) {
+  size_t radius = 0;
+
+  for (; radius < len - 1; radius++, trail++) {
+    if (data[radius] >= STRONG_TARGET) {
+      *trail = 1;
+    } else if (*trail > 0 && *trail < TRAIL_MAX_REVOLUTIONS) {
+      (*trail)++;
+    }
+    if (data[radius] < WEAK_TARGET) {
+      data[radius] = colour[*trail];
+    }
+  }
+  for (; radius < spoke_len; radius++, trail++) {
+    *trail = 0;
+  }
+}
+
+// A revolution in which the spoke was not received: the stamps age its trails anyway, the old code did not
+static void AgeTrails(TrailRevolutionsAge *trail, size_t spoke_len) {
+  for (size_t radius = 0; radius < spoke_len; radius++, trail++) {
+    if (*trail > 0 && *trail < TRAIL_MAX_REVOLUTIONS) {
+      (*trail)++;
+    }
+  }
+}
+
+// TrailBuffer::UpdateTrueTrails as it was on a dense image, with every age incremented once per revolution
+// (see AgeImage).
+static void ReferenceTrueTrails(vector<TrailRevolutionsAge> &image, int size, PolarToCartesianLookup *lookup,
+                                size_t bearing, uint8_t *data, size_t len, const uint8_t *colour) {
+  for (size_t radius = 0; radius + 1 < len; radius++) {
+    PointInt p = lookup->GetPointInt(bearing, radius);
+    size_t pixel = (size_t)((p.x + size / 2) & (size - 1)) * size + ((p.y + size / 2) & (size - 1));
+    if (data[radius] >= STRONG_TARGET) {
+      image[pixel] = 1;
+    } else if (data[radius] < WEAK_TARGET) {
+      data[radius] = colour[image[pixel]];
+    }
+  }
+}
+
+static void AgeImage(vector<TrailRevolutionsAge> &image) {
+  for (size_t i = 0; i < image.size(); i++) {
+    if (image[i] > 0 && image[i] < TRAIL_MAX_REVOLUTIONS) {
+      image[i]++;
+    }
+  }
+}
+
+// Spokes as a radar would send them: a few targets that move, noise and sometimes a shorter spoke.
+// Without traffic there is only the target that leaves a trail in the first revolutions.
+static void MakeSpoke(int revolution, int angle, bool traffic, uint8_t *data, size_t *len) {
+  *len = (revolution % 23 == 7) ? SPOKE_LEN - 5 : SPOKE_LEN;
+  for (size_t radius = 0; radius < *len; radius++) {
+    int v = traffic ? rand() % 1000 : 1000;
+    data[radius] = (v < 3) ? 255 : (v < 100) ? (uint8_t)(rand() % (STRONG_TARGET + 1)) : 0;
+  }
+  for (int target = 0; target < 3; target++) {
+    // target 2 is only seen in the first revolutions, to leave a trail behind
+    if ((target == 2) ? revolution > 5 : !traffic) {
+      continue;
+    }
+    int target_angle = (target * 20 + revolution / (3 + target)) % SPOKES;
+    int target_radius = (target * 13 + revolution / (5 + target)) % (SPOKE_LEN - 2);
+    if (angle == target_angle || angle == (target_angle + 1) % SPOKES) {
+      data[target_radius] = 220;
+      data[target_radius + 1] = 255;
+    }
+  }
+}
+
+// Spokes from a capture of a Navico radar, expanded as NavicoReceive does with doppler off
+struct Capture {
+  vector<uint16_t> angle;  // 0 .. NAVICO_SPOKES - 1
+  vector<uint8_t> data;    // NAVICO_SPOKE_LEN per spoke
+  vector<size_t> first;    // first spoke of each revolution, then the number of spokes
+};
+
+#define NAVICO_FRAME_HEADER (8)
+#define NAVICO_LINE_HEADER (24)
+#define NAVICO_LINE (NAVICO_LINE_HEADER + NAVICO_SPOKE_LEN / 2)
+
+// A frame is an 8 byte header and a number of lines, each a 24 byte header and the packed returns
+static void AddFrame(Capture *capture, const uint8_t *frame, size_t len) {
+  if (len < NAVICO_FRAME_HEADER + NAVICO_LINE || (len - NAVICO_FRAME_HEADER) % NAVICO_LINE != 0) {
+    return;  // not a frame
+  }
+  for (const uint8_t *line = frame + NAVICO_FRAME_HEADER; line < frame + len; line += NAVICO_LINE) {
+    if (line[0] != NAVICO_LINE_HEADER) {
+      continue;
+    }
+    uint16_t angle = (uint16_t)(((line[9] << 8) | line[8]) / 2 % NAVICO_SPOKES);
+    if (capture->angle.empty() || angle < capture->angle.back()) {
+      capture->first.push_back(capture->angle.size());
+    }
+    capture->angle.push_back(angle);
+    capture->data.resize(capture->data.size() + NAVICO_SPOKE_LEN);
+    NavicoExpandSpoke(line + NAVICO_LINE_HEADER, &capture->data[capture->data.size() - NAVICO_SPOKE_LEN],
+                      NAVICO_SPOKE_LEN / 2, 0);
+  }
+}
+
+// Reads the frames from a pcap file, gzipped or not, such as those in example/. The frames are bigger than the
+// MTU, so the IP fragments are put together again; a datagram that misses a fragment is skipped.
+static bool ReadCapture(const char *path, Capture *capture) {
+  gzFile file = gzopen(path, "rb");
+  uint8_t header[24];
+  uint8_t record[16];
+  vector<uint8_t> packet;
+  map<unsigned, vector<uint8_t> > datagrams;  // by IP id
+
+  if (!file) {
+    return false;
+  }
+  if (gzread(file, header, sizeof(header)) != sizeof(header) || header[0] != 0xd4 || header[1] != 0xc3) {
+    gzclose(file);  // only little endian pcap, not pcapng
+    return false;
+  }
+  size_t link_header = header[20] == 113 ? 16 : 14;  // Linux cooked capture or Ethernet
+
+  while (gzread(file, record, sizeof(record)) == sizeof(record)) {
+    size_t captured = record[8] | record[9] << 8 | record[10] << 16 | (size_t)record[11] << 24;
+    packet.resize(captured);
+    if (gzread(file, packet.data(), (unsigned)captured) != (int)captured) {
+      break;
+    }
+    const uint8_t *ip = packet.data() + link_header;
+    if (captured < link_header + 20 || (ip[0] >> 4) != 4 || ip[9] != 17) {
+      continue;  // not UDP over IPv4
+    }
+    size_t ip_header = (ip[0] & 15) * 4;
+    size_t ip_len = wxMin((size_t)(ip[2] << 8 | ip[3]), captured - link_header);
+    unsigned fragment = ip[6] << 8 | ip[7];
+    bool more = (fragment & 0x2000) != 0;
+    size_t offset = (fragment & 0x1fff) * 8;
+    if (ip_len <= ip_header) {
+      continue;
+    }
+
+    vector<uint8_t> &datagram = datagrams[ip[4] << 8 | ip[5]];
+    if (offset != datagram.size()) {
+      datagrams.erase(ip[4] << 8 | ip[5]);
+      continue;
+    }
+    datagram.insert(datagram.end(), ip + ip_header, ip + ip_len);
+    if (!more) {
+      if (datagram.size() > 8) {
+        AddFrame(capture, &datagram[8], datagram.size() - 8);  // after the UDP header
+      }
+      datagrams.erase(ip[4] << 8 | ip[5]);
+    }
+  }
+  gzclose(file);
+  capture->first.push_back(capture->angle.size());
+  return !capture->angle.empty();
+}
+
+// Runs the relative and the true trails of TrailSpoke against the references, with the same spokes. These are
+// made up by MakeSpoke, or when `capture` is set, are all revolutions of the capture.
+static int Compare(PolarToCartesianLookup *lookup, const Capture *capture, int maxRev, TrailRevolution first_revolution,
+                   int revolutions, bool traffic, unsigned int seed) {
+  size_t spokes = capture ? NAVICO_SPOKES : SPOKES;
+  size_t spoke_len = capture ? NAVICO_SPOKE_LEN : SPOKE_LEN;
+  uint8_t colour[TRAIL_MAX_REVOLUTIONS + 1];
+  vector<TrailRevolutionsAge> reference(spokes * spoke_len, 0);
+  vector<TrailRevolution> relative(spokes * spoke_len, 0);
+  vector<int> swept(spokes, 0);  // the last revolution in which `reference` was updated, per spoke
+  TrailTiles tiles(2 * spoke_len);
+  int size = tiles.GetSize();
+  vector<TrailRevolutionsAge> reference_image((size_t)size * size, 0);
+  TrailRevolution now = first_revolution;
+  vector<uint8_t> data(spoke_len);
+  vector<uint8_t> true_data(spoke_len);
+  vector<uint8_t> ref_data(spoke_len);
+  vector<uint8_t> ref_true_data(spoke_len);
+  size_t len;
+
+  if (capture) {
+    revolutions = (int)capture->first.size() - 1;
+  }
+
+  TrailColours(maxRev, colour);
+  TrailTargets targets;
+  targets.weak = WEAK_TARGET;
+  targets.strong = STRONG_TARGET;
+  targets.colour = colour;
+
+  srand(seed);
+  for (int revolution = 0; revolution < revolutions; revolution++) {
+    if (revolution > 0) {
+      now = NextTrailRevolution(now);
+      if (now % TRAIL_RENORMALIZE == 0) {
+        for (size_t i = 0; i < relative.size(); i++) {
+          relative[i] = RenormalizeTrailRevolution(now, relative[i]);
+        }
+        tiles.Renormalize(now);
+      }
+      AgeImage(reference_image);
+    }
+    size_t count = capture ? capture->first[revolution + 1] - capture->first[revolution] : spokes;
+    for (size_t n = 0; n < count; n++) {
+      size_t angle = n;
+      if (capture) {
+        size_t spoke = capture->first[revolution] + n;
+        angle = capture->angle[spoke];
+        len = spoke_len;
+        memcpy(data.data(), &capture->data[spoke * spoke_len], len);
+      } else {
+        MakeSpoke(revolution, (int)angle, traffic, data.data(), &len);
+      }
+      memcpy(ref_data.data(), data.data(), len);
+      memcpy(true_data.data(), data.data(), len);
+      memcpy(ref_true_data.data(), data.data(), len);
+      for (; swept[angle] + 1 < revolution; swept[angle]++) {
+        AgeTrails(&reference[angle * spoke_len], spoke_len);  // only in captures, which miss some spokes
+      }
+      swept[angle] = revolution;
+      ReferenceTrails(&reference[angle * spoke_len], spoke_len, ref_data.data(), len, colour);
+      UpdateRelativeTrailSpoke(&relative[angle * spoke_len], spoke_len, now, data.data(), len, targets, true);
+      ReferenceTrueTrails(reference_image, size, lookup, angle, ref_true_data.data(), len, colour);
+      UpdateTrueTrailSpoke(&tiles, lookup, angle, size / 2, size / 2, now, true_data.data(), len, targets, true);
+      if (memcmp(data.data(), ref_data.data(), len) != 0 || memcmp(true_data.data(), ref_true_data.data(), len) != 0) {
+        cout << "ERROR: trail length " << maxRev << " revolutions, starting at " << first_revolution << ", revolution "
+             << revolution << " spoke " << angle << " differs in the "
+             << (memcmp(data.data(), ref_data.data(), len) != 0 ? "relative" : "true") << " trails\n";
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// With a capture, its spokes go through the trails as well, see ReadCapture.
+int TrailAgeTest(const char *capture_path) {
+  static const int maxRevs[] = {
+      SECONDS_TO_REVOLUTIONS(15),  SECONDS_TO_REVOLUTIONS(30),  SECONDS_TO_REVOLUTIONS(60), SECONDS_TO_REVOLUTIONS(180),
+      SECONDS_TO_REVOLUTIONS(300), SECONDS_TO_REVOLUTIONS(600), TRAIL_MAX_REVOLUTIONS + 1};
+  int ret = 0;
+
+  if (TrailAge(5, 0) != 0 || TrailAge(5, 5) != 1 || TrailAge(5, 4) != 2 || TrailAge(2, 65535) != 3 || TrailAge(1, 65535) != 2 ||
+      TrailAge(1000, 1) != TRAIL_MAX_REVOLUTIONS) {
+    cout << "ERROR: TrailAge is wrong\n";
+    ret = 1;
+  }
+  if (NextTrailRevolution(65535) != 1 || RenormalizeTrailRevolution(10, 60000) != 65304) {
+    cout << "ERROR: NextTrailRevolution does not skip 0\n";
+    ret = 1;
+  }
+
+  PolarToCartesianLookup *lookup = PolarToCartesianLookup::Get(SPOKES, SPOKE_LEN);
+  for (size_t i = 0; i < sizeof(maxRevs) / sizeof(maxRevs[0]); i++) {
+    ret |= CompareColours(maxRevs[i]);
+    ret |= Compare(lookup, 0, maxRevs[i], 1, 700, true, 1 + i);
+  }
+  // Across renormalizing and the wrap of the revolution counter
+  ret |= Compare(lookup, 0, TRAIL_MAX_REVOLUTIONS + 1, 57000, 10000, true, 42);
+  ret |= Compare(lookup, 0, SECONDS_TO_REVOLUTIONS(60), 65000, 1500, true, 43);
+  // Trails that have faded must not come back when the counter comes round
+  ret |= Compare(lookup, 0, SECONDS_TO_REVOLUTIONS(60), 1, TRAIL_REVOLUTION_WRAP + 1000, false, 44);
+  PolarToCartesianLookup::Release(lookup);
+
+  if (capture_path) {
+    Capture capture;
+    NavicoInitializeLookupData();
+    if (!ReadCapture(capture_path, &capture)) {
+      cout << "ERROR: no Navico spokes in " << capture_path << "\n";
+      return 1;
+    }
+    cout << "INFO: " << capture.angle.size() << " spokes in " << capture.first.size() - 1 << " revolutions from "
+         << capture_path << "\n";
+    lookup = PolarToCartesianLookup::Get(NAVICO_SPOKES, NAVICO_SPOKE_LEN);
+    // Starting just before the wrap of the revolution counter
+    ret |= Compare(lookup, &capture, SECONDS_TO_REVOLUTIONS(15), TRAIL_REVOLUTION_WRAP - 5, 0, false, 0);
+    ret |= Compare(lookup, &capture, TRAIL_MAX_REVOLUTIONS + 1, TRAIL_REVOLUTION_WRAP - 5, 0, false, 0);
+    PolarToCartesianLookup::Release(lookup);
+  }
+
+  if (ret == 0) {
+    cout << "INFO: TrailSpoke with revolution stamps matches per sweep aging\n";
+  }
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+// TrailAge-test [capture.pcap.gz]
+int main(int argc, char *argv[]) { return PLUGIN_NAMESPACE::TrailAgeTest(argc > 1 ? argv[1] : 0); }
@@ -31,6 +31,8 @@
 
 #include "TrailBuffer.h"
 
+#include "TrailSpoke.h"
+
 #undef M_SETTINGS
 #define M_SETTINGS m_ri->m_pi->m_settings
 
@@ -42,8 +44,8 @@ PLUGIN_BEGIN_NAMESPACE
 // Striding the first dimension makes for better locality because
 // we generally iterate over the range (process one spoke) so those
 // values are now closer together in memory.
-#define M_TRUE_TRAILS_STRIDE m_trail_size
-#define M_TRUE_TRAILS(x, y) m_true_trails[x * M_TRUE_TRAILS_STRIDE + y]
+// The true trails are kept in TrailTiles, which only stores tiles with returns.
+// Both hold the revolution of the last return, see TrailAge.h.
 #define M_RELATIVE_TRAILS_STRIDE m_max_spoke_len
 #define M_RELATIVE_TRAILS(x, y) m_relative_trails[x * M_RELATIVE_TRAILS_STRIDE + y]
 
@@ -52,13 +54,19 @@ TrailBuffer::TrailBuffer(RadarInfo *ri, size_t spokes, size_t max_spoke_len) {
   m_spokes = spokes;
   m_max_spoke_len = (int)max_spoke_len;
   m_previous_pixels_per_meter = 0.;
+  m_true_sweep.index = 0;
+  m_true_sweep.revolution = 1;
+  m_relative_sweep = m_true_sweep;
   m_trail_size = max_spoke_len * 2 + MARGIN * 2;
-  m_true_trails = (TrailRevolutionsAge *)calloc(sizeof(TrailRevolutionsAge), m_trail_size * m_trail_size);
-  m_relative_trails = (TrailRevolutionsAge *)calloc(sizeof(TrailRevolutionsAge), m_spokes * m_max_spoke_len);
-  m_copy_true_trails = (TrailRevolutionsAge *)calloc(sizeof(TrailRevolutionsAge), m_trail_size * m_trail_size);
-  m_copy_relative_trails = (TrailRevolutionsAge *)calloc(sizeof(TrailRevolutionsAge), m_spokes * m_max_spoke_len);
-
-  if (!m_true_trails || !m_relative_trails || !m_copy_true_trails || !m_copy_relative_trails) {
+  m_true_trails = new TrailTiles(m_trail_size);
+  m_relative_trails = (TrailRevolution *)calloc(sizeof(TrailRevolution), m_spokes * m_max_spoke_len);
+  m_copy_true_trails = new TrailTiles(m_trail_size);
+  m_copy_relative_trails = (TrailRevolution *)calloc(sizeof(TrailRevolution), m_spokes * m_max_spoke_len);
+  m_zoom_map = (int *)malloc(m_trail_size * sizeof(int));
+  m_zoom_relative_map = (int *)malloc((m_max_spoke_len + 1) * sizeof(int));
+
+  if (!m_true_trails || !m_relative_trails || !m_copy_true_trails || !m_copy_relative_trails || !m_zoom_map ||
+      !m_zoom_relative_map) {
     wxLogError(wxT("Out Of Memory, fatal!"));
     wxAbort();
   }
@@ -66,113 +74,136 @@ TrailBuffer::TrailBuffer(RadarInfo *ri, size_t spokes, size_t max_spoke_len) {
 }
 
 TrailBuffer::~TrailBuffer() {
-  free(m_true_trails);
+  delete m_true_trails;
   free(m_relative_trails);
   free(m_copy_relative_trails);
-  free(m_copy_true_trails);
+  delete m_copy_true_trails;
+  free(m_zoom_map);
+  free(m_zoom_relative_map);
+}
+
+// Counts the revolutions of one trail image: the spoke index went back by more than half a circle.
+// The index of true trails is a bearing, which can also go back a little when the heading changes.
+// Returns true when the image is due for renormalizing.
+bool TrailBuffer::CountRevolution(TrailSweep *sweep, SpokeBearing index) {
+  bool wrapped = index + (int)m_spokes / 2 < sweep->index;
+
+  sweep->index = index;
+  if (wrapped) {
+    sweep->revolution = NextTrailRevolution(sweep->revolution);
+    return (sweep->revolution % TRAIL_RENORMALIZE) == 0;
+  }
+  return false;
 }
 
 void TrailBuffer::UpdateTrueTrails(SpokeBearing bearing, uint8_t *data, size_t len) {
   RadarControlState trails = m_ri->m_target_trails.GetState();
 
+  if (CountRevolution(&m_true_sweep, bearing)) {
+    m_true_trails->Renormalize(m_true_sweep.revolution);
+  }
+
   if (trails != RCS_OFF) {
     int motion = m_ri->m_trails_motion.GetValue();
     bool update_targets_true = (motion == TARGET_MOTION_TRUE);
 
-    uint8_t weak_target = M_SETTINGS.threshold_blue;
-    uint8_t strong_target = M_SETTINGS.threshold_red;
-    size_t radius = 0;
-
-    for (; radius < len - 1; radius++) {  //  len - 1 : no trails on range circle
-      PointInt point = m_ri->m_polar_lookup->GetPointInt(bearing, radius);
-
-      point.x += m_trail_size / 2 + m_offset.lat;
-      point.y += m_trail_size / 2 + m_offset.lon;
-
-      if (point.x >= 0 && point.x < (int)m_trail_size && point.y >= 0 && point.y < (int)m_trail_size) {
-        uint8_t *trail = &M_TRUE_TRAILS(point.x, point.y);
-        // when ship moves north, offset.lat > 0. Add to move trails image in opposite direction
-        // when ship moves east, offset.lon > 0. Add to move trails image in opposite direction
-        if (data[radius] >= strong_target) {
-          *trail = 1;
-        } else if (*trail > 0 && *trail < TRAIL_MAX_REVOLUTIONS) {
-          (*trail)++;
-        }
-
-        if (update_targets_true && (data[radius] < weak_target)) {
-          data[radius] = m_ri->m_trail_colour[*trail];
-        }
-      }
-    }
-
-    // Now process the rest of the spoke from len to m_spoke_len_max.
-    // This will only be called when the current spoke length is smaller than the max.
-    // we need to update the trail 'age' for those points.
-    for (; radius < m_ri->m_spoke_len_max; radius++) {
-      PointInt point = m_ri->m_polar_lookup->GetPointInt(bearing, radius);
-
-      point.x += m_trail_size / 2 + m_offset.lat;
-      point.y += m_trail_size / 2 + m_offset.lon;
-
-      if (point.x >= 0 && point.x < (int)m_trail_size && point.y >= 0 && point.y < (int)m_trail_size) {
-        uint8_t *trail = &M_TRUE_TRAILS(point.x, m_trail_size + point.y);
-        // when ship moves north, offset.lat > 0. Add to move trails image in opposite direction
-        // when ship moves east, offset.lon > 0. Add to move trails image in opposite direction
-        if (*trail > 0 && *trail < TRAIL_MAX_REVOLUTIONS) {
-          (*trail)++;
-        }
-      }
-    }
+    TrailTargets targets;
+    targets.weak = M_SETTINGS.threshold_blue;
+    targets.strong = M_SETTINGS.threshold_red;
+    targets.colour = m_ri->m_trail_colour;
+
+    // when ship moves north, offset.lat > 0. Add to move trails image in opposite direction
+    // when ship moves east, offset.lon > 0. Add to move trails image in opposite direction
+    int center_x = m_trail_size / 2 + m_offset.lat;
+    int center_y = m_trail_size / 2 + m_offset.lon;
+    UpdateTrueTrailSpoke(m_true_trails, m_ri->m_polar_lookup, bearing, center_x, center_y, m_true_sweep.revolution, data,
+                         len, targets, update_targets_true);
   }
 }
 
 void TrailBuffer::UpdateRelativeTrails(SpokeBearing angle, uint8_t *data, size_t len) {
   int motion = m_ri->m_trails_motion.GetValue();
   RadarControlState trails = m_ri->m_target_trails.GetState();
-  if (trails != RCS_OFF) {
-    uint8_t *trail = &M_RELATIVE_TRAILS(angle, 0);
-    size_t radius = 0;
 
-    bool update_relative_motion = motion == TARGET_MOTION_RELATIVE;
+  if (CountRevolution(&m_relative_sweep, angle)) {
+    for (size_t i = 0; i < m_spokes * m_max_spoke_len; i++) {
+      m_relative_trails[i] = RenormalizeTrailRevolution(m_relative_sweep.revolution, m_relative_trails[i]);
+    }
+  }
 
-    uint8_t weak_target = M_SETTINGS.threshold_blue;
-    uint8_t strong_target = M_SETTINGS.threshold_red;
+  if (trails != RCS_OFF) {
+    bool update_relative_motion = motion == TARGET_MOTION_RELATIVE;
 
-    for (radius = 0; radius < len - 1; radius++, trail++) {  // len - 1 : no trails on range circle
-      if (data[radius] >= strong_target) {
-        *trail = 1;
-      } else if (*trail > 0 && *trail < TRAIL_MAX_REVOLUTIONS) {
-        (*trail)++;
-      }
+    TrailTargets targets;
+    targets.weak = M_SETTINGS.threshold_blue;
+    targets.strong = M_SETTINGS.threshold_red;
+    targets.colour = m_ri->m_trail_colour;
 
-      if (update_relative_motion && (data[radius] < weak_target)) {
-        data[radius] = m_ri->m_trail_colour[*trail];
-      }
-    }
+    UpdateRelativeTrailSpoke(&M_RELATIVE_TRAILS(angle, 0), m_max_spoke_len, m_relative_sweep.revolution, data, len, targets,
+                             update_relative_motion);
+  }
+}
 
-    for (; radius < (size_t)m_max_spoke_len; radius++, trail++)  // And clear out empty bit of spoke when spoke_len < max_spoke_len
-    {
-      *trail = 0;
-    }
+// The zoom writes the rows of the true trails from left to right, so the tile row of the last pixel is kept at hand
+struct ZoomRow {
+  int x;
+  int t;
+  TrailRevolution *row;
+};
+
+static inline TrailRevolution *ZoomPixel(TrailTiles *tiles, ZoomRow *cursor, int y) {
+  y &= tiles->GetSize() - 1;
+  if ((y >> TRAIL_TILE_BITS) != cursor->t) {
+    cursor->t = y >> TRAIL_TILE_BITS;
+    cursor->row = tiles->GetRow(cursor->x, cursor->t);
   }
+  return cursor->row + (y & TRAIL_TILE_MASK);
 }
 
 // Zooms the trailbuffer (containing image of true trails) in and out
-// This version assumes m_offset.lon and m_offset.lat to be zero (earlier versions did zoom offset as well)
+// The true trails are zoomed around the current position of the ship in the image (m_offset)
 // zoom_factor > 1 -> zoom in, enlarge image
 void TrailBuffer::ZoomTrails(float zoom_factor) {
-  uint8_t *flip;
-  memset(m_copy_relative_trails, 0, m_spokes * m_max_spoke_len);
-
-  // zoom relative trails
+  TrailRevolution *flip;
+
+  // Index maps, made once per zoom. The new radius of j is j * zoom_factor, which never goes down, so the radii that
+  // move to index_j are a range: m_zoom_relative_map[index_j] .. m_zoom_relative_map[index_j + 1] - 1.
+  int index_j = 0;
+  for (int j = 0; j < m_max_spoke_len; j++) {
+    int to = j * zoom_factor;
+    if (to >= m_max_spoke_len) break;
+    while (index_j <= to) {
+      m_zoom_relative_map[index_j++] = j;
+    }
+  }
+  while (index_j <= m_max_spoke_len) {
+    m_zoom_relative_map[index_j++] = m_max_spoke_len;
+  }
+  // The same for the rows and columns of the true trails, but stored as where each one goes.
+  int begin = m_trail_size;
+  int end = 0;
+  for (int k = MARGIN; k < m_trail_size - MARGIN; k++) {
+    int index = (int)(((double)k - (double)m_trail_size / 2) * zoom_factor + (double)m_trail_size / 2);
+    if (index >= m_trail_size - 1) {
+      break;  // allow adding an additional pixel later
+    }
+    m_zoom_map[k] = index;
+    if (index >= 0) {
+      begin = wxMin(begin, k);
+      end = k + 1;
+    }
+  }
 
+  // zoom relative trails, every new radius gets the last trail of the radii that move there (or 0)
   for (int i = 0; i < (int)m_spokes; i++) {
-    for (int j = 0; j < m_max_spoke_len; j++) {
-      int index_j = j * zoom_factor;
-      if (index_j >= m_max_spoke_len) break;
-      if (M_RELATIVE_TRAILS(i, j) != 0) {
-        m_copy_relative_trails[i * M_RELATIVE_TRAILS_STRIDE + index_j] = M_RELATIVE_TRAILS(i, j);
+    const TrailRevolution *from = &M_RELATIVE_TRAILS(i, 0);
+    TrailRevolution *to = &m_copy_relative_trails[i * M_RELATIVE_TRAILS_STRIDE];
+    for (int k = 0; k < m_max_spoke_len; k++) {
+      TrailRevolution pixel = 0;
+      for (int j = m_zoom_relative_map[k]; j < m_zoom_relative_map[k + 1]; j++) {
+        pixel = from[j] ? from[j] : pixel;
       }
+      to[k] = pixel;
     }
   }
   // Now exchange the two
@@ -180,58 +211,51 @@ void TrailBuffer::ZoomTrails(float zoom_factor) {
   m_relative_trails = m_copy_relative_trails;
   m_copy_relative_trails = flip;
 
-  memset(m_copy_true_trails, 0, m_trail_size * m_trail_size);
-
-  // zoom true trails
-  for (int i = MARGIN; i < m_trail_size - MARGIN; i++) {
-    int index_i = (int)(((double)i - (double)m_trail_size / 2) * zoom_factor + (double)m_trail_size / 2);
-    if (index_i >= m_trail_size - 1) {
-      break;  // allow adding an additional pixel later
-    }
-    if (index_i < 0) {
-      continue;
-    }
-    for (int j = MARGIN; j < m_trail_size - MARGIN; j++) {
-      int index_j = (int)(((double)j - (double)m_trail_size / 2) * zoom_factor + (double)m_trail_size / 2);
-      if (index_j >= (int)m_trail_size - 1) {
-        break;
-      }
-      if (index_j < 0) {
-        continue;
-      }
-      uint8_t pixel = M_TRUE_TRAILS(i, j);
-      if (pixel != 0) {  // many to one mapping, prevent overwriting trails with 0
-        m_copy_true_trails[index_i * M_TRUE_TRAILS_STRIDE + index_j] = pixel;
-        if (zoom_factor > 1.2) {
-          // add an extra pixel in the y direction
-          m_copy_true_trails[index_i * M_TRUE_TRAILS_STRIDE + index_j + 1] = pixel;
-          if (zoom_factor > 1.6) {
-            // also add pixels in the x direction
-            m_copy_true_trails[(index_i + 1) * M_TRUE_TRAILS_STRIDE + index_j] = pixel;
-            m_copy_true_trails[(index_i + 1) * M_TRUE_TRAILS_STRIDE + index_j + 1] = pixel;
+  m_copy_true_trails->Clear();
+
+  // zoom true trails, only rows and tiles that hold trails.
+  // i and j are relative to the image around the ship, the tiles are addressed with m_offset added.
+  int mask = m_true_trails->GetSize() - 1;
+  for (int i = begin; i < end; i++) {
+    int x = i + m_offset.lat;
+    ZoomRow to_row = {m_zoom_map[i] + m_offset.lat, -1, 0};
+    ZoomRow to_next_row = {to_row.x + 1, -1, 0};
+    for (int j = begin; j < end;) {
+      int y = (j + m_offset.lon) & mask;
+      int p = y & TRAIL_TILE_MASK;
+      int span = wxMin(TRAIL_TILE - p, end - j);
+      TrailRevolution *row = m_true_trails->FindRow(x, y >> TRAIL_TILE_BITS);
+      for (int k = 0; row && k < span; k++) {
+        TrailRevolution pixel = row[p + k];
+        if (pixel != 0) {  // many to one mapping, prevent overwriting trails with 0
+          int to_y = m_zoom_map[j + k] + m_offset.lon;
+          *ZoomPixel(m_copy_true_trails, &to_row, to_y) = pixel;
+          if (zoom_factor > 1.2) {
+            // add an extra pixel in the y direction
+            *ZoomPixel(m_copy_true_trails, &to_row, to_y + 1) = pixel;
+            if (zoom_factor > 1.6) {
+              // also add pixels in the x direction
+              *ZoomPixel(m_copy_true_trails, &to_next_row, to_y) = pixel;
+              *ZoomPixel(m_copy_true_trails, &to_next_row, to_y + 1) = pixel;
+            }
           }
         }
       }
+      j += span;
     }
   }
-  flip = m_true_trails;
-  m_true_trails = m_copy_true_trails;
-  m_copy_true_trails = flip;
+  m_true_trails->Swap(*m_copy_true_trails);
+  m_copy_true_trails->Clear();
 }
 
-void TrailBuffer::UpdateTrailPosition() {
-  GeoPosition radar;
+// radar is where the spoke was received, NaN when there is no position. This runs in the trails lane, so it must
+// not take RadarInfo::m_exclusive: the process thread holds that while it waits for the lane.
+void TrailBuffer::UpdateTrailPosition(const GeoPosition &radar) {
   GeoPositionPixels shift;
   // When position changes the trail image is not moved, only the pointer to the center
   // of the image (offset) is changed.
-  // So we move the image around within the m_trails.true_trails buffer (by moving the pointer).
-  // But when there is no room anymore (margin used) the whole trails image is shifted
-  // and the offset is reset
-  if (m_offset.lon >= MARGIN || m_offset.lon <= -MARGIN || m_offset.lat >= MARGIN || m_offset.lat <= -MARGIN) {
-    LOG_INFO(wxT("offset lat %d or lon too large %d"), m_offset.lat, m_offset.lon);
-    ClearTrails();
-    return;
-  }
+  // The true trails image wraps around at its edges, so the offset can move on forever:
+  // only the strip of the image that comes into view has to be cleared.
 
   // zooming of trails required? First check conditions
   if (m_previous_pixels_per_meter == 0. || m_ri->m_pixels_per_meter == 0.) {
@@ -249,14 +273,14 @@ void TrailBuffer::UpdateTrailPosition() {
       return;
     }
     m_previous_pixels_per_meter = m_ri->m_pixels_per_meter;
-    // center the image before zooming
-    // otherwise the offset might get too large
-    ShiftImageLatToCenter();
-    ShiftImageLonToCenter();
     ZoomTrails(zoom_factor);
   }
 
-  if (!m_ri->GetRadarPosition(&radar) || m_ri->m_pi->GetHeadingSource() == HEADING_NONE) {
+  if (!VALID_GEO(radar.lat) || !VALID_GEO(radar.lon) || m_ri->m_pi->GetHeadingSource() == HEADING_NONE) {
+    return;
+  }
+  if (!VALID_GEO(m_pos.lat)) {
+    m_pos = radar;  // first position since the trails were cleared
     return;
   }
 
@@ -277,48 +301,6 @@ void TrailBuffer::UpdateTrailPosition() {
   shift.lat = (int)(fshift_lat + m_dif.lat);
   shift.lon = (int)(fshift_lon + m_dif.lon);
 
-  // Check for changes in the direction of movement, part of the image buffer has to be erased
-
-  if (shift.lat > 0 && m_ri->m_dir_lat <= 0) {
-    // change of direction of movement, moving north now
-    // clear space in trailbuffer above image (this area might not be empty)
-    uint8_t *start_of_area_to_clear = m_true_trails + (m_trail_size - MARGIN + m_offset.lat) * m_trail_size;
-    int number_of_pixels_to_clear = (MARGIN - m_offset.lat) * m_trail_size;
-    memset(start_of_area_to_clear, 0, number_of_pixels_to_clear);
-    m_ri->m_dir_lat = 1;
-  }
-
-  if (shift.lat < 0 && m_ri->m_dir_lat >= 0) {
-    // change of direction of movement, moving south now
-    // clear space in true_trails below image
-    uint8_t *start_of_area_to_clear = m_true_trails;
-    int number_of_pixels_to_clear = (MARGIN + m_offset.lat) * m_trail_size;
-    memset(start_of_area_to_clear, 0, number_of_pixels_to_clear);
-    m_ri->m_dir_lat = -1;
-  }
-
-  if (shift.lon > 0 && m_ri->m_dir_lon <= 0) {
-    // change of direction of movement, moving east now
-    // clear space in true_trails to the right of image
-    int number_of_pixels_to_clear = MARGIN - m_offset.lon;
-    for (int i = 0; i < m_trail_size; i++) {
-      uint8_t *start_of_area_to_clear = m_true_trails + m_trail_size * i + m_trail_size - MARGIN + m_offset.lon;
-      memset(start_of_area_to_clear, 0, number_of_pixels_to_clear);
-    }
-    m_ri->m_dir_lon = 1;
-  }
-
-  if (shift.lon < 0 && m_ri->m_dir_lon >= 0) {
-    // change of direction of movement, moving west now
-    // clear space in true_trails outside image in that direction
-    int number_of_pixels_to_clear = MARGIN + m_offset.lon;
-    for (int i = 0; i < m_trail_size; i++) {
-      uint8_t *start_of_area_to_clear = m_true_trails + m_trail_size * i;
-      memset(start_of_area_to_clear, 0, number_of_pixels_to_clear);
-    }
-    m_ri->m_dir_lon = -1;
-  }
-
   // save the rounding fraction and appy it next time
   m_dif.lat = fshift_lat + m_dif.lat - (double)shift.lat;
   m_dif.lon = fshift_lon + m_dif.lon - (double)shift.lon;
@@ -330,81 +312,23 @@ void TrailBuffer::UpdateTrailPosition() {
     return;
   }
 
-  // offset lon too large: shift image
-  if (abs(m_offset.lon + shift.lon) >= MARGIN) {
-    ShiftImageLonToCenter();
-  }
-
-  // offset lat too large: shift image in lat direction
-  if (abs(m_offset.lat + shift.lat) >= MARGIN) {
-    ShiftImageLatToCenter();
-  }
-  // apply the shifts to the offset
-  m_offset.lat += shift.lat;
-  m_offset.lon += shift.lon;
-}
-
-// shifts the true trails image in lat direction to center
-void TrailBuffer::ShiftImageLatToCenter() {
-  int image_size = m_trail_size * 2 * m_max_spoke_len;  // number of pixels to shift up / down
-
-  if (m_offset.lat >= MARGIN || m_offset.lat <= -MARGIN) {  // abs not ok
-    LOG_INFO(wxT("offset lat too large %i"), m_offset.lat);
-    ClearTrails();
-    return;
+  // The image around the ship is rows and columns m_offset .. m_offset + m_trail_size - 1 of the torus.
+  // Clear the strip that moves into it, that still holds trails from the far side of the torus.
+  if (shift.lat > 0) {  // moving north
+    m_true_trails->ClearRows(m_offset.lat + m_trail_size, shift.lat);
+  } else if (shift.lat < 0) {  // moving south
+    m_true_trails->ClearRows(m_offset.lat + shift.lat, -shift.lat);
   }
-  // current starting location of shifted image
-  uint8_t *source_address = m_true_trails + (MARGIN + m_offset.lat) * m_trail_size;
-  // location where centered image should be
-  uint8_t *destination_address = m_true_trails + MARGIN * m_trail_size;
-  // size of image to be shifted, extended to the full width of trailbuffer
-  image_size = m_trail_size * 2 * m_max_spoke_len;
-  memmove(destination_address, source_address, image_size);
-  uint8_t *start_of_area_to_clear;
-  int number_of_pixels_to_clear = MARGIN * m_trail_size;
-  if (m_offset.lat > 0) {
-    // clear upper area of trailbuffer which is now outside the image
-    start_of_area_to_clear = m_true_trails + (m_trail_size - MARGIN) * m_trail_size;
-  } else {
-    // clear lower area of trailbuffer which is now outside the image
-    start_of_area_to_clear = m_true_trails;
+  if (shift.lon > 0) {  // moving east
+    m_true_trails->ClearColumns(m_offset.lon + m_trail_size, shift.lon);
+  } else if (shift.lon < 0) {  // moving west
+    m_true_trails->ClearColumns(m_offset.lon + shift.lon, -shift.lon);
   }
-  memset(start_of_area_to_clear, 0, number_of_pixels_to_clear);
-  m_offset.lat = 0;
-}
 
-// shifts the true trails image in lon direction to center
-void TrailBuffer::ShiftImageLonToCenter() {
-  if (m_offset.lon >= MARGIN || m_offset.lon <= -MARGIN) {  // abs no good
-    LOG_INFO(wxT("offset lon too large %i"), m_offset.lon);
-    ClearTrails();
-    return;
-  }
-  // number of pixels to shift right / left
-  int line_of_image_size = 2 * m_max_spoke_len;
-  // MARGIN is where the centered line should start
-  // shift per line, rigth / left
-  for (int i = 0; i < m_trail_size; i++) {
-    // current starting location of image
-    uint8_t *source_address = m_true_trails + i * m_trail_size + MARGIN + m_offset.lon;
-    // location where centered image should be
-    uint8_t *destination_address = m_true_trails + i * m_trail_size + MARGIN;
-    memmove(destination_address, source_address, line_of_image_size);
-
-    uint8_t *start_of_area_to_clear;
-    // offset > 0, we shifted to the left, so clear area to the right of image
-    if (m_offset.lon > 0) {
-      // start clear at end of the line minus current margin
-      start_of_area_to_clear = m_true_trails + i * m_trail_size + m_trail_size - MARGIN;
-    }
-    // offset <= 0, we shifted to the right, so clear area to the left of image
-    else {
-      // start clear at start of the line
-      start_of_area_to_clear = m_true_trails + i * m_trail_size;
-    }
-    memset(start_of_area_to_clear, 0, MARGIN);
-  }
-  m_offset.lon = 0;
+  // apply the shifts to the offset, it wraps around with the image
+  int mask = m_true_trails->GetSize() - 1;
+  m_offset.lat = (m_offset.lat + shift.lat) & mask;
+  m_offset.lon = (m_offset.lon + shift.lon) & mask;
 }
 
 void TrailBuffer::ClearTrails() {
@@ -415,15 +339,14 @@ void TrailBuffer::ClearTrails() {
   // prevent zooming of trails in next trail update
   m_previous_pixels_per_meter = m_ri->m_pixels_per_meter;
   if (m_true_trails) {
-    memset(m_true_trails, 0, m_trail_size * m_trail_size);
+    m_true_trails->Clear();
   }
   if (m_relative_trails) {
-    memset(m_relative_trails, 0, m_spokes * m_max_spoke_len);
-  }
-  if (!m_ri->GetRadarPosition(&m_pos)) {
-    m_pos.lat = 0.;
-    m_pos.lon = 0.;
+    memset(m_relative_trails, 0, m_spokes * m_max_spoke_len * sizeof(TrailRevolution));
   }
+  // The next UpdateTrailPosition() starts from where the radar is then
+  m_pos.lat = nan("");
+  m_pos.lon = nan("");
 }
 
 PLUGIN_END_NAMESPACE
@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "TrailSpoke.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+void UpdateRelativeTrailSpoke(TrailRevolution *trail, size_t spoke_len_max, TrailRevolution now, uint8_t *data, size_t len,
+                              const TrailTargets &targets, bool recolour) {
+  size_t radius = 0;
+
+  for (; radius + 1 < len; radius++, trail++) {  // len - 1 : no trails on range circle
+    if (data[radius] >= targets.strong) {
+      *trail = now;
+    } else if (recolour && data[radius] < targets.weak) {
+      data[radius] = targets.colour[TrailAge(now, *trail)];
+    }
+  }
+  for (; radius < spoke_len_max; radius++, trail++) {  // And clear out empty bit of spoke when len < spoke_len_max
+    *trail = 0;
+  }
+}
+
+void UpdateTrueTrailSpoke(TrailTiles *tiles, PolarToCartesianLookup *lookup, size_t bearing, int center_x, int center_y,
+                          TrailRevolution now, uint8_t *data, size_t len, const TrailTargets &targets, bool recolour) {
+  // Only returns are written, the age of the other pixels follows from the revolution count.
+  // The part of the spoke beyond len needs no work at all.
+  for (size_t radius = 0; radius + 1 < len; radius++) {  //  len - 1 : no trails on range circle
+    bool strong = data[radius] >= targets.strong;
+    bool colour = recolour && data[radius] < targets.weak;
+    if (!strong && !colour) {
+      continue;
+    }
+    // The image wraps around, so every point is inside it
+    PointInt point = lookup->GetPointInt(bearing, radius);
+    point.x += center_x;
+    point.y += center_y;
+
+    if (strong) {
+      *tiles->Get(point.x, point.y) = now;
+    } else {
+      // A pixel in a tile that does not exist yet is 0: no trail
+      TrailRevolution *trail = tiles->Find(point.x, point.y);
+      data[radius] = targets.colour[trail ? TrailAge(now, *trail) : 0];
+    }
+  }
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,160 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "TrailTiles.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+TrailTiles::TrailTiles(int size) {
+  m_size = TRAIL_TILE;
+  while (m_size < size) {
+    m_size <<= 1;
+  }
+  m_mask = m_size - 1;
+  m_tiles_per_row = m_size / TRAIL_TILE;
+  m_tile_count = 0;
+  m_tiles = (TrailRevolution **)calloc(sizeof(TrailRevolution *), m_tiles_per_row * m_tiles_per_row);
+  if (!m_tiles) {
+    wxLogError(wxT("Out Of Memory, fatal!"));
+    wxAbort();
+  }
+}
+
+TrailTiles::~TrailTiles() {
+  Clear();
+  free(m_tiles);
+}
+
+TrailRevolution *TrailTiles::NewTile() {
+  TrailRevolution *tile = (TrailRevolution *)calloc(sizeof(TrailRevolution), TRAIL_TILE_PIXELS);
+  if (!tile) {
+    wxLogError(wxT("Out Of Memory, fatal!"));
+    wxAbort();
+  }
+  m_tile_count++;
+  return tile;
+}
+
+void TrailTiles::Clear() {
+  for (int t = 0; t < m_tiles_per_row * m_tiles_per_row; t++) {
+    if (m_tiles[t]) {
+      free(m_tiles[t]);
+      m_tiles[t] = 0;
+    }
+  }
+  m_tile_count = 0;
+}
+
+// Zero a rectangle that does not wrap; tiles that are completely inside it are freed
+void TrailTiles::ClearRect(int x, int rows, int y, int columns) {
+  int x_end = x + rows;
+  int y_end = y + columns;
+
+  if (x >= x_end || y >= y_end) {
+    return;
+  }
+  for (int tx = x >> TRAIL_TILE_BITS; tx <= (x_end - 1) >> TRAIL_TILE_BITS; tx++) {
+    for (int ty = y >> TRAIL_TILE_BITS; ty <= (y_end - 1) >> TRAIL_TILE_BITS; ty++) {
+      TrailRevolution **tile = &m_tiles[tx * m_tiles_per_row + ty];
+      if (!*tile) {
+        continue;
+      }
+      int px_begin = wxMax(x - tx * TRAIL_TILE, 0);
+      int px_end = wxMin(x_end - tx * TRAIL_TILE, TRAIL_TILE);
+      int py_begin = wxMax(y - ty * TRAIL_TILE, 0);
+      int py_end = wxMin(y_end - ty * TRAIL_TILE, TRAIL_TILE);
+      if (px_begin == 0 && px_end == TRAIL_TILE && py_begin == 0 && py_end == TRAIL_TILE) {
+        free(*tile);
+        *tile = 0;
+        m_tile_count--;
+        continue;
+      }
+      for (int px = px_begin; px < px_end; px++) {
+        memset(*tile + (px << TRAIL_TILE_BITS) + py_begin, 0, (py_end - py_begin) * sizeof(TrailRevolution));
+      }
+    }
+  }
+}
+
+void TrailTiles::ClearRows(int x, int rows) {
+  if (rows >= m_size) {
+    Clear();
+    return;
+  }
+  if (rows <= 0) {
+    return;
+  }
+  x &= m_mask;
+  int first = wxMin(rows, m_size - x);
+  ClearRect(x, first, 0, m_size);
+  ClearRect(0, rows - first, 0, m_size);  // the part that wrapped around
+}
+
+void TrailTiles::ClearColumns(int y, int columns) {
+  if (columns >= m_size) {
+    Clear();
+    return;
+  }
+  if (columns <= 0) {
+    return;
+  }
+  y &= m_mask;
+  int first = wxMin(columns, m_size - y);
+  ClearRect(0, m_size, y, first);
+  ClearRect(0, m_size, 0, columns - first);
+}
+
+void TrailTiles::Swap(TrailTiles &other) {
+  TrailRevolution **tiles = m_tiles;
+  size_t tile_count = m_tile_count;
+
+  m_tiles = other.m_tiles;
+  m_tile_count = other.m_tile_count;
+  other.m_tiles = tiles;
+  other.m_tile_count = tile_count;
+}
+
+void TrailTiles::Renormalize(TrailRevolution now) {
+  for (int t = 0; t < m_tiles_per_row * m_tiles_per_row; t++) {
+    TrailRevolution *tile = m_tiles[t];
+    if (tile) {
+      for (int p = 0; p < TRAIL_TILE_PIXELS; p++) {
+        tile[p] = RenormalizeTrailRevolution(now, tile[p]);
+      }
+    }
+  }
+}
+
+size_t TrailTiles::GetMemoryUsed() {
+  return m_tiles_per_row * m_tiles_per_row * sizeof(TrailRevolution *) + m_tile_count * TRAIL_TILE_PIXELS * sizeof(TrailRevolution);
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,177 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "VertexArena.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+#define LINES (256)
+#define MIN_SLOT (96)
+#define MAX_LINE (6 * 1024)
+#define UNIT (12)  // sizeof a vertex
+
+struct TestLine {
+  VertexSlot slot;
+  size_t count;
+  uint8_t tag;
+};
+
+// Every line holds `count` units filled with its tag, and no two slots overlap
+static bool Check(VertexArena *arena, std::vector<TestLine> &lines) {
+  std::vector<uint8_t> owner(arena->GetCapacity(), 0);
+  size_t used = 0;
+
+  for (size_t i = 0; i < lines.size(); i++) {
+    TestLine &line = lines[i];
+    if (!line.slot.size) {
+      continue;
+    }
+    used += line.slot.size;
+    if (line.slot.offset + line.slot.size > arena->GetCapacity() || line.count > line.slot.size) {
+      cout << "ERROR: line " << i << " slot is outside the arena\n";
+      return false;
+    }
+    for (size_t u = line.slot.offset; u < line.slot.offset + line.slot.size; u++) {
+      if (owner[u]) {
+        cout << "ERROR: line " << i << " overlaps another line\n";
+        return false;
+      }
+      owner[u] = 1;
+    }
+    const uint8_t *data = (const uint8_t *)arena->Get(line.slot);
+    for (size_t b = 0; b < line.count * UNIT; b++) {
+      if (data[b] != line.tag) {
+        cout << "ERROR: line " << i << " lost its data\n";
+        return false;
+      }
+    }
+  }
+  if (used != arena->GetUsed()) {
+    cout << "ERROR: arena says " << arena->GetUsed() << " units are used, the lines hold " << used << "\n";
+    return false;
+  }
+  return true;
+}
+
+// Rewrites line i with `count` units the way RadarDrawVertex does: grow while filling, compact afterwards
+static bool Rewrite(VertexArena *arena, TestLine &line, size_t count) {
+  line.tag++;
+  line.count = 0;
+  if (!line.slot.size && !arena->Alloc(MIN_SLOT, &line.slot)) {
+    return false;
+  }
+  while (line.count < count) {
+    if (line.count == line.slot.size && !arena->Resize(&line.slot, line.count, line.count + 6)) {
+      return false;
+    }
+    memset((uint8_t *)arena->Get(line.slot) + line.count * UNIT, line.tag, UNIT);
+    line.count++;
+  }
+  if (line.slot.size > MIN_SLOT && line.count * 4 <= line.slot.size) {
+    arena->Resize(&line.slot, line.count, line.count * 2);
+  }
+  return true;
+}
+
+int VertexArenaTest() {
+  VertexArena arena(UNIT, MIN_SLOT, LINES * MAX_LINE);
+  std::vector<TestLine> lines(LINES);
+  int ret = 0;
+
+  for (size_t i = 0; i < LINES; i++) {
+    lines[i].slot.size = 0;
+    lines[i].count = 0;
+    lines[i].tag = (uint8_t)i;
+  }
+
+  // Clutter comes and goes: the arena grows while it builds up, then stops growing
+  unsigned int generation = 0;
+  for (int revolution = 0; revolution < 40 && ret == 0; revolution++) {
+    size_t clutter = (revolution / 10) % 2 ? 40 : 600;
+
+    if (revolution == 5) {
+      generation = arena.GetGeneration();
+    }
+    for (size_t i = 0; i < LINES; i++) {
+      if (!Rewrite(&arena, lines[i], rand() % clutter)) {
+        cout << "ERROR: no room in revolution " << revolution << "\n";
+        ret = 1;
+        break;
+      }
+    }
+    if (!Check(&arena, lines)) {
+      ret = 1;
+    }
+    if (revolution == 10) {
+      // Quiet after busy: the lines have compacted back
+      if (arena.GetUsed() * 3 > arena.GetPeak()) {
+        cout << "ERROR: lines did not compact, used " << arena.GetUsed() << " peak " << arena.GetPeak() << "\n";
+        ret = 1;
+      }
+    }
+  }
+  if (arena.GetGeneration() != generation) {
+    cout << "ERROR: arena still grew after it had seen the busiest picture\n";
+    ret = 1;
+  }
+  cout << "INFO: " << LINES << " lines use " << arena.GetUsed() << " units, peak " << arena.GetPeak() << ", arena "
+       << arena.GetCapacity() << " units, moved " << arena.GetGeneration() << " times\n";
+
+  // At the cap bigger free slots are split, and when nothing fits Alloc fails cleanly
+  VertexArena small(UNIT, MIN_SLOT, 4 * MIN_SLOT);
+  VertexSlot a, b, c;
+  if (!small.Alloc(4 * MIN_SLOT, &a)) {
+    cout << "ERROR: cannot fill a small arena\n";
+    ret = 1;
+  }
+  small.Free(&a);
+  if (!small.Alloc(MIN_SLOT, &b) || !small.Alloc(2 * MIN_SLOT, &c) || b.offset == c.offset) {
+    cout << "ERROR: free slot is not split\n";
+    ret = 1;
+  }
+  if (small.Alloc(4 * MIN_SLOT, &a)) {
+    cout << "ERROR: arena grew beyond its maximum\n";
+    ret = 1;
+  }
+
+  if (ret == 0) {
+    cout << "INFO: vertex arena keeps slots apart and stops growing\n";
+  }
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main() { return PLUGIN_NAMESPACE::VertexArenaTest(); }
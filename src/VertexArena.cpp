@@ -0,0 +1,158 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "VertexArena.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+VertexArena::VertexArena(size_t unit_size, size_t min_slot, size_t max_units) {
+  m_unit_size = unit_size;
+  m_min_slot = min_slot;
+  m_max_units = wxMin(max_units, (size_t)NONE);
+  m_data = 0;
+  m_capacity = 0;
+  m_top = 0;
+  for (int c = 0; c < CLASSES; c++) {
+    m_free[c] = NONE;
+  }
+  m_used = 0;
+  m_peak = 0;
+  m_generation = 0;
+}
+
+VertexArena::~VertexArena() { free(m_data); }
+
+int VertexArena::ClassOf(size_t units) {
+  int c = 0;
+
+  while ((m_min_slot << c) < units) {
+    c++;
+  }
+  return c;
+}
+
+size_t VertexArena::GetSlotSize(size_t units) { return m_min_slot << ClassOf(units); }
+
+// The free lists are linked through the first bytes of each free slot
+uint32_t VertexArena::Pop(int c) {
+  uint32_t offset = m_free[c];
+
+  if (offset != NONE) {
+    memcpy(&m_free[c], m_data + (size_t)offset * m_unit_size, sizeof(uint32_t));
+  }
+  return offset;
+}
+
+void VertexArena::Push(int c, uint32_t offset) {
+  memcpy(m_data + (size_t)offset * m_unit_size, &m_free[c], sizeof(uint32_t));
+  m_free[c] = offset;
+}
+
+bool VertexArena::Reserve(size_t units) {
+  if (units <= m_capacity) {
+    return true;
+  }
+  if (units > m_max_units) {
+    return false;
+  }
+  // Grow by at least half, so a growing picture only moves the block a few times
+  size_t capacity = wxMin(wxMax(units, m_capacity + m_capacity / 2), m_max_units);
+  uint8_t *data = (uint8_t *)realloc(m_data, capacity * m_unit_size);
+  if (!data) {
+    return false;
+  }
+  m_data = data;
+  m_capacity = capacity;
+  m_generation++;
+  return true;
+}
+
+bool VertexArena::Alloc(size_t units, VertexSlot *slot) {
+  int c = ClassOf(units);
+  size_t size = m_min_slot << c;
+
+  if (c >= CLASSES) {
+    return false;
+  }
+  uint32_t offset = Pop(c);
+  if (offset == NONE) {
+    if (Reserve(m_top + size)) {
+      offset = (uint32_t)m_top;
+      m_top += size;
+    } else {
+      // Out of room: split a bigger free slot, giving the upper halves to the smaller free lists
+      int bigger = c + 1;
+      while (bigger < CLASSES && m_free[bigger] == NONE) {
+        bigger++;
+      }
+      if (bigger >= CLASSES) {
+        return false;
+      }
+      offset = Pop(bigger);
+      while (bigger > c) {
+        bigger--;
+        Push(bigger, offset + (uint32_t)(m_min_slot << bigger));
+      }
+    }
+  }
+  slot->offset = offset;
+  slot->size = (uint32_t)size;
+  m_used += size;
+  m_peak = wxMax(m_peak, m_used);
+  return true;
+}
+
+void VertexArena::Free(VertexSlot *slot) {
+  if (slot->size) {
+    Push(ClassOf(slot->size), slot->offset);
+    m_used -= slot->size;
+    slot->size = 0;
+  }
+}
+
+bool VertexArena::Resize(VertexSlot *slot, size_t keep, size_t units) {
+  VertexSlot moved;
+
+  if (slot->size == GetSlotSize(units)) {
+    return true;
+  }
+  if (!Alloc(units, &moved)) {
+    return false;
+  }
+  if (keep && slot->size) {
+    memcpy(Get(moved), Get(*slot), wxMin(keep, (size_t)moved.size) * m_unit_size);
+  }
+  Free(slot);
+  *slot = moved;
+  return true;
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+/*
+ * Microbenchmark of the RadarControlItem reads done for every spoke.
+ *
+ * ProcessRadarSpoke and its consumers read about seven controls per spoke (main bang, threshold,
+ * range adjustment, doppler, target trails, trails motion, overlay transparency). This compares
+ * the lock-free RadarControlItem with the previous implementation that took a wxCriticalSection
+ * for every read, both on its own and with a second thread reading and writing the same controls
+ * the way the GUI thread does.
+ *
+ * Built by cmake -DRADAR_BENCHMARK=ON, target radar-control-bench. See cmake/PluginBenchmark.cmake.
+ *
+ * Usage: radar-control-bench [spokes]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "RadarControlItem.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+typedef std::chrono::steady_clock Clock;
+
+// The reads as they were done before RadarControlItem kept value and state in an atomic word
+class LockedControlItem {
+ public:
+  LockedControlItem() {
+    m_value = 0;
+    m_state = RCS_OFF;
+  }
+
+  void Update(int v, RadarControlState s) {
+    wxCriticalSectionLocker lock(m_exclusive);
+    m_value = v;
+    m_state = s;
+  }
+
+  int GetValue() {
+    wxCriticalSectionLocker lock(m_exclusive);
+    return m_value;
+  }
+
+  RadarControlState GetState() {
+    wxCriticalSectionLocker lock(m_exclusive);
+    return m_state;
+  }
+
+ private:
+  wxCriticalSection m_exclusive;
+  int m_value;
+  RadarControlState m_state;
+};
+
+#define CONTROLS (7)
+
+template <class Item>
+static int ReadSpokeControls(Item *items) {
+  int sum = 0;
+
+  for (int i = 0; i < CONTROLS - 1; i++) {
+    sum += items[i].GetValue();
+  }
+  sum += (int)items[CONTROLS - 1].GetState();  // m_target_trails is read for its state
+  return sum;
+}
+
+template <class Item>
+static double TimeSpokes(Item *items, long spokes, bool contended) {
+  std::atomic<bool> stop(false);
+  std::thread gui;
+  volatile int sink = 0;
+
+  if (contended) {
+    gui = std::thread([&]() {
+      int n = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        sink = ReadSpokeControls(items);
+        items[n % CONTROLS].Update(n % 100, RCS_MANUAL);
+        n++;
+      }
+    });
+  }
+
+  Clock::time_point start = Clock::now();
+  for (long s = 0; s < spokes; s++) {
+    sink = ReadSpokeControls(items);
+  }
+  double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+  stop = true;
+  if (gui.joinable()) {
+    gui.join();
+  }
+  return ns / spokes;
+}
+
+int ControlItemBench(long spokes) {
+  LockedControlItem locked[CONTROLS];
+  RadarControlItem atomic[CONTROLS];
+
+  printf("%d control reads per spoke, %ld spokes\n", CONTROLS, spokes);
+  printf("  %-30s %8.1f ns/spoke\n", "locked", TimeSpokes(locked, spokes, false));
+  printf("  %-30s %8.1f ns/spoke\n", "atomic", TimeSpokes(atomic, spokes, false));
+  printf("  %-30s %8.1f ns/spoke\n", "locked, GUI thread active", TimeSpokes(locked, spokes, true));
+  printf("  %-30s %8.1f ns/spoke\n", "atomic, GUI thread active", TimeSpokes(atomic, spokes, true));
+  return 0;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main(int argc, char *argv[]) {
+  long spokes = 10000000;
+
+  if (argc > 1) {
+    spokes = atol(argv[1]);
+  }
+  if (spokes <= 0) {
+    cout << "Usage: radar-control-bench [spokes]\n";
+    return 1;
+  }
+  return PLUGIN_NAMESPACE::ControlItemBench(spokes);
+}
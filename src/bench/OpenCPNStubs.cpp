@@ -0,0 +1,86 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+/*
+ * The OpenCPN plugin API, for the headless benchmarks.
+ *
+ * The plugin normally gets these from the OpenCPN executable. The benchmark links the plugin sources
+ * without it, so every API function that the plugin calls is defined here, doing nothing. A call the
+ * plugin adds later must get its stub here as well, the link fails until it does.
+ */
+
+#include "radar_pi.h"
+
+int InsertPlugInToolSVG(wxString label, wxString SVGfile, wxString SVGfileRollover, wxString SVGfileToggled,
+                        wxItemKind kind, wxString shortHelp, wxString longHelp, wxObject *clientData, int position,
+                        int tool_sel, opencpn_plugin *pplugin) {
+  return -1;
+}
+void SetToolbarToolBitmapsSVG(int item, wxString SVGfile, wxString SVGfileRollover, wxString SVGfileToggled) {}
+
+int AddCanvasContextMenuItem(wxMenuItem *pitem, opencpn_plugin *pplugin) { return -1; }
+void RemoveCanvasContextMenuItem(int item) {}
+void SetCanvasContextMenuItemViz(int item, bool viz) {}
+void SetCanvasContextMenuItemGrey(int item, bool grey) {}
+
+wxFileConfig *GetOCPNConfigObject(void) { return 0; }
+wxWindow *GetOCPNCanvasWindow() { return 0; }
+wxAuiManager *GetFrameAuiManager(void) { return 0; }
+wxString *GetpSharedDataLocation() {
+  static wxString location;
+  return &location;
+}
+wxString GetPluginDataDir(const char *plugin_name) { return wxEmptyString; }
+bool AddLocaleCatalog(wxString catalog) { return false; }
+void DimeWindow(wxWindow *) {}
+
+int GetCanvasCount() { return 0; }
+wxWindow *GetCanvasByIndex(int canvasIndex) { return 0; }
+int GetCanvasIndexUnderMouse() { return 0; }
+void GetCanvasPixLL(PlugIn_ViewPort *vp, wxPoint *pp, double lat, double lon) {
+  pp->x = 0;
+  pp->y = 0;
+}
+void GetCanvasLLPix(PlugIn_ViewPort *vp, wxPoint p, double *plat, double *plon) {
+  *plat = 0.;
+  *plon = 0.;
+}
+
+wxFont *OCPNGetFont(wxString TextElement, int default_size) { return wxNORMAL_FONT; }
+wxFont *GetOCPNScaledFont_PlugIn(wxString TextElement, int default_size) { return wxNORMAL_FONT; }
+wxFont GetOCPNGUIScaledFont_PlugIn(wxString item) { return *wxNORMAL_FONT; }
+wxColour GetFontColour_PlugIn(wxString TextElement) { return *wxBLACK; }
+bool PlugInSetFontColor(const wxString TextElement, const wxColour color) { return false; }
+void PlugInAISDrawGL(wxGLCanvas *glcanvas, const PlugIn_ViewPort &vp) {}
+
+void PushNMEABuffer(wxString str) {}
+void SendPluginMessage(wxString message_id, wxString message_body) {}
+bool PlugInPlaySound(wxString &sound_file) { return false; }
@@ -0,0 +1,384 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+/*
+ * Headless benchmark of the spoke pipeline.
+ *
+ * Pushes synthetic spokes through RadarInfo::ProcessRadarSpoke (threshold, history, guard zone,
+ * true and relative trails, vertex and shader draw) for the geometry of several radar types and
+ * reports the throughput, the time spent in each stage and the number of heap allocations per spoke.
+ * Then it times the trail zoom for every step between adjacent ranges of the range tables.
+ *
+ * With process threads the spoke consumers run on a SpokeWorkers pool, and the spokes are handed to
+ * ProcessRadarSpoke in batches under RadarInfo::m_exclusive, the way RadarProcess does.
+ *
+ * Built by cmake -DRADAR_BENCHMARK=ON, target radar-spoke-bench. See cmake/PluginBenchmark.cmake.
+ *
+ * Usage: radar-spoke-bench [revolutions] [process threads]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+
+#include "GuardZone.h"
+#include "RadarDrawShader.h"
+#include "RadarDrawVertex.h"
+#include "RadarFactory.h"
+#include "RadarInfo.h"
+#include "SpokePreprocess.h"
+#include "SpokeWorkers.h"
+#include "TrailBuffer.h"
+#include "radar_pi.h"
+
+// Count every heap allocation made by the plugin code: malloc and friends are wrapped by the linker
+// (-Wl,--wrap=...), operator new is replaced here.
+static std::atomic<size_t> g_allocations(0);
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+void *__wrap_malloc(size_t size) {
+  g_allocations++;
+  return __real_malloc(size);
+}
+void *__wrap_calloc(size_t n, size_t size) {
+  g_allocations++;
+  return __real_calloc(n, size);
+}
+void *__wrap_realloc(void *p, size_t size) {
+  g_allocations++;
+  return __real_realloc(p, size);
+}
+}
+
+void *operator new(size_t size) {
+  g_allocations++;
+  void *p = __real_malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+PLUGIN_BEGIN_NAMESPACE
+
+typedef std::chrono::steady_clock Clock;
+
+#define SPOKES_PER_LOCK 64  // as RadarProcess
+
+static double ElapsedNanos(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+struct BenchGeometry {
+  const char *name;
+  RadarType type;
+  int range_meters;
+};
+
+static const BenchGeometry geometries[] = {
+    {"Navico HALO 2048x1024", RT_HaloA, 3000},
+    {"Garmin xHD 1440x705", RT_GARMIN_XHD, 3000},
+    {"Raymarine Quantum 250", RM_QUANTUM, 3000},
+    {"Raymarine E120 2048", RM_E120, 3000},
+};
+
+enum BenchStage {
+  STAGE_PREPROCESS,
+  STAGE_GUARD_ZONE,
+  STAGE_TRUE_TRAILS,
+  STAGE_RELATIVE_TRAILS,
+  STAGE_COLOUR_SPOKE,  // before the draws, which use its runs
+  STAGE_DRAW_VERTEX,
+  STAGE_DRAW_SHADER,
+  STAGES
+};
+
+static const char *stage_names[STAGES] = {"preprocess",   "guard zone",  "true trails", "relative trails",
+                                          "colour spoke", "draw vertex", "draw shader"};
+
+// A plausible picture: sea clutter close in, a coastline, some targets and a bit of noise
+static void MakeSpokes(size_t spokes, size_t spoke_len, vector<uint8_t> &data) {
+  data.resize(spokes * spoke_len);
+  srand(1);
+  for (size_t a = 0; a < spokes; a++) {
+    uint8_t *line = &data[a * spoke_len];
+    size_t land = spoke_len * 2 / 3 + (a * 7 % 64);
+    bool coast = a < spokes / 3;
+
+    for (size_t r = 0; r < spoke_len; r++) {
+      int v = rand() % 40;  // noise
+      if (r < spoke_len / 16) {
+        v += (int)((spoke_len / 16 - r) * 3000 / spoke_len) + rand() % 60;  // sea clutter
+      }
+      if (coast && r >= land) {
+        v = 160 + rand() % 96;
+      }
+      line[r] = (uint8_t)wxMin(v, 254);
+    }
+    for (int t = 0; t < 3; t++) {  // targets a few samples long, a few spokes wide
+      size_t r = (spoke_len / 5) * (t + 1) + (a / 16 % 8);
+      if ((a / 8) % 10 == (size_t)t * 3 && r + 6 < spoke_len) {
+        memset(line + r, 230, 6);
+      }
+    }
+  }
+}
+
+// Zoom the trails for every step between two adjacent ranges in the range tables of the radar, both ways.
+// Before each step the trails get one revolution of spokes at the old range; only the zoom itself is timed.
+static void RunRangeSteps(RadarInfo *ri, const vector<uint8_t> &source) {
+  static const RangeUnits units[] = {RANGE_METRIC, RANGE_NAUTIC, RANGE_MIXED};
+  size_t spokes = ri->m_spokes;
+  size_t len = ri->m_spoke_len_max;
+  vector<uint8_t> spoke(len);
+  int steps = 0;
+  double total_ns = 0.;
+  double max_ns = 0.;
+  double max_factor = 0.;
+  GeoPosition pos;
+
+  ri->GetRadarPosition(&pos);
+  for (size_t u = 0; u < ARRAY_SIZE(units); u++) {
+    const int *ranges;
+    size_t n = RadarFactory::GetRadarRanges(ri->m_radar_type, units[u], &ranges);
+
+    for (size_t i = 0; i + 1 < n; i++) {
+      for (int down = 0; down < 2; down++) {
+        int from = down ? ranges[i + 1] : ranges[i];
+        int to = down ? ranges[i] : ranges[i + 1];
+
+        ri->m_pixels_per_meter = len / (double)from;
+        ri->m_trails->UpdateTrailPosition(pos);
+        for (size_t a = 0; a < spokes; a++) {
+          memcpy(&spoke[0], &source[a * len], len);
+          ri->m_trails->UpdateTrueTrails(a, &spoke[0], len);
+          ri->m_trails->UpdateRelativeTrails(a, &spoke[0], len);
+        }
+
+        ri->m_pixels_per_meter = len / (double)to;
+        Clock::time_point start = Clock::now();
+        ri->m_trails->UpdateTrailPosition(pos);
+        double ns = ElapsedNanos(start);
+
+        total_ns += ns;
+        steps++;
+        if (ns > max_ns) {
+          max_ns = ns;
+          max_factor = (double)from / to;
+        }
+      }
+    }
+  }
+  printf("  %-26s %8.2f ms average, %.2f ms max (zoom %.2f), %d range steps\n", "trail zoom", total_ns / wxMax(steps, 1) / 1e6,
+         max_ns / 1e6, max_factor, steps);
+}
+
+static void SetupPlugin(radar_pi *pi) {
+  pi->m_settings.threshold_blue = 32;
+  pi->m_settings.threshold_green = 100;
+  pi->m_settings.threshold_red = 200;
+  pi->m_settings.max_age = 6;
+  pi->m_settings.strong_colour = wxColour(255, 0, 0);
+  pi->m_settings.intermediate_colour = wxColour(0, 255, 0);
+  pi->m_settings.weak_colour = wxColour(0, 0, 255);
+  pi->m_settings.doppler_approaching_colour = wxColour(255, 255, 0);
+  pi->m_settings.doppler_receding_colour = wxColour(0, 255, 255);
+  pi->m_settings.trail_start_colour = wxColour(255, 255, 255);
+  pi->m_settings.trail_end_colour = wxColour(63, 63, 63);
+  pi->m_settings.overlay_transparency.Update(DEFAULT_OVERLAY_TRANSPARENCY);
+  pi->m_settings.trails_on_overlay = false;
+  pi->m_settings.show_extreme_range = false;
+  pi->m_settings.merge_vertex_blobs = true;
+  pi->m_bpos_set = true;
+}
+
+// Hands one revolution of spokes to ProcessRadarSpoke like RadarProcess::Entry: in batches while holding m_exclusive,
+// waiting for the workers at the end of each batch. Returns the time taken.
+static double ProcessRevolution(RadarInfo *ri, const vector<uint8_t> &source, vector<uint8_t> &spoke, int range_meters,
+                                wxLongLong now) {
+  size_t spokes = ri->m_spokes;
+  size_t len = ri->m_spoke_len_max;
+  Clock::time_point start = Clock::now();
+
+  for (size_t a = 0; a < spokes;) {
+    wxCriticalSectionLocker lock(ri->m_exclusive);
+
+    for (int n = 0; a < spokes && n < SPOKES_PER_LOCK; n++, a++) {
+      memcpy(&spoke[0], &source[a * len], len);
+      ri->ProcessRadarSpoke(a, a, &spoke[0], len, range_meters, now);
+    }
+    if (ri->m_workers) {
+      ri->m_workers->Wait();
+    }
+  }
+  return ElapsedNanos(start);
+}
+
+static int RunGeometry(radar_pi *pi, const BenchGeometry &g, int revolutions, int threads) {
+  RadarInfo *ri = new RadarInfo(pi, 0);
+  ri->m_radar_type = g.type;
+  ri->InitSpokeProcessing();
+
+  size_t spokes = ri->m_spokes;
+  size_t len = ri->m_spoke_len_max;
+
+  GeoPosition pos;
+  pos.lat = 52.0;
+  pos.lon = 4.0;
+  ri->SetRadarPosition(pos, 0.);
+
+  ri->m_target_trails.Update(TRAIL_CONTINUOUS, RCS_MANUAL);
+  ri->m_trails_motion.Update(TARGET_MOTION_TRUE);
+  ri->ComputeTargetTrails();
+
+  GuardZone *zone = ri->m_guard_zone[0];
+  zone->SetType(GZ_CIRCLE);
+  zone->SetInnerRange(g.range_meters / 10);
+  zone->SetOuterRange(g.range_meters / 2);
+  zone->SetAlarmOn(1);
+
+  RadarDrawVertex *vertex = new RadarDrawVertex(ri);
+  RadarDrawShader *shader = new RadarDrawShader(ri);
+  if (!vertex->Init(spokes, len) || !shader->InitData(spokes, len)) {
+    cout << "ERROR: " << g.name << ": cannot allocate draw buffers\n";
+    return 1;
+  }
+  ri->m_draw_panel.draw = vertex;
+  ri->m_draw_overlay.draw = shader;
+  if (threads > 0) {
+    ri->m_workers = new SpokeWorkers(ri, threads, len);
+  }
+
+  vector<uint8_t> source;
+  vector<uint8_t> spoke(len);
+  vector<BlobRun> runs(len + 1);
+  MakeSpokes(spokes, len, source);
+
+  // Warm up: fill trails, history and the vertex arrays once
+  wxLongLong now = wxGetUTCTimeMillis();
+  ProcessRevolution(ri, source, spoke, g.range_meters, now);
+
+  // The whole pipeline
+  size_t total_spokes = 0;
+  double total_ns = 0.;
+  size_t allocations = g_allocations;
+  for (int rev = 0; rev < revolutions; rev++) {
+    total_ns += ProcessRevolution(ri, source, spoke, g.range_meters, now);
+    total_spokes += spokes;
+  }
+  allocations = g_allocations - allocations;
+
+  // Each stage on its own, with the same input
+  double stage_ns[STAGES] = {0.};
+  for (int rev = 0; rev < revolutions; rev++) {
+    for (size_t a = 0; a < spokes; a++) {
+      for (int s = 0; s < STAGES; s++) {
+        memcpy(&spoke[0], &source[a * len], len);
+        Clock::time_point start = Clock::now();
+        switch (s) {
+          case STAGE_PREPROCESS:
+            PreprocessSpoke(&spoke[0], len, ri->m_history[a].line, len, 0, 0, pi->m_settings.threshold_red, false);
+            break;
+          case STAGE_GUARD_ZONE:
+            zone->ProcessSpoke(a, &spoke[0], ri->m_history[a].line, len);
+            break;
+          case STAGE_TRUE_TRAILS:
+            ri->m_trails->UpdateTrueTrails(a, &spoke[0], len);
+            break;
+          case STAGE_RELATIVE_TRAILS:
+            ri->m_trails->UpdateRelativeTrails(a, &spoke[0], len);
+            break;
+          case STAGE_COLOUR_SPOKE:
+            ColourSpoke(&spoke[0], len, ri->m_colour_map, &runs[0]);
+            break;
+          case STAGE_DRAW_VERTEX:
+            vertex->ProcessRadarSpoke(4, a, &runs[0], len, pos);
+            break;
+          case STAGE_DRAW_SHADER:
+            shader->ProcessRadarSpoke(4, a, &runs[0], len, pos);
+            break;
+        }
+        stage_ns[s] += ElapsedNanos(start);
+      }
+    }
+  }
+
+  double per_spoke = total_ns / total_spokes;
+  double stages_ns = 0.;
+  printf("%s: %d spokes of %d, %d process threads, %.0f spokes/s, %.0f ns/spoke, %.2f allocations/spoke\n", g.name,
+         (int)spokes, (int)len, threads, 1e9 / per_spoke, per_spoke, (double)allocations / total_spokes);
+  for (int s = 0; s < STAGES; s++) {
+    printf("  %-26s %8.0f ns\n", stage_names[s], stage_ns[s] / total_spokes);
+    stages_ns += stage_ns[s] / total_spokes;
+  }
+  printf("  %-26s %8.0f ns\n", "other", wxMax(per_spoke - stages_ns, 0.));
+
+  RunRangeSteps(ri, source);
+
+  delete ri;  // also deletes the draws
+  return 0;
+}
+
+int SpokeBench(int revolutions, int threads) {
+  int ret = 0;
+  radar_pi *pi = new radar_pi(0);
+
+  SetupPlugin(pi);
+  for (size_t i = 0; i < ARRAY_SIZE(geometries); i++) {
+    ret |= RunGeometry(pi, geometries[i], revolutions, threads);
+  }
+  // pi is not deleted, its destructor expects a plugin that went through Init()
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main(int argc, char **argv) {
+  wxInitializer initializer;  // console only, no display needed
+
+  if (!initializer.IsOk()) {
+    cout << "ERROR: cannot initialize wxWidgets\n";
+    return 1;
+  }
+  int revolutions = (argc > 1) ? atoi(argv[1]) : 10;
+  int threads = (argc > 2) ? atoi(argv[2]) : 0;
+  return PLUGIN_NAMESPACE::SpokeBench(wxMax(revolutions, 1), wxMax(threads, 0));
+}
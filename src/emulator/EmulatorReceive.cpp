@@ -58,8 +58,7 @@ PLUGIN_BEGIN_NAMESPACE
 void EmulatorReceive::EmulateFakeBuffer(void) {
   time_t now = time(0);
   uint8_t data[EMULATOR_MAX_SPOKE_LEN];
-
-  wxCriticalSectionLocker lock(m_ri->m_exclusive);
+  LatencyTimer timer(m_ri->m_latency, LATENCY_DECODE);
 
   m_ri->m_radar_timeout = now + WATCHDOG_TIMEOUT;
 
@@ -133,7 +132,7 @@ void EmulatorReceive::EmulateFakeBuffer(void) {
     int bearing = MOD_SPOKES(angle + hdt);
 
     wxLongLong time_rec = wxGetUTCTimeMillis();
-    m_ri->ProcessRadarSpoke(angle, bearing, data, sizeof(data), range_meters, time_rec);
+    m_ri->QueueRadarSpoke(angle, bearing, data, sizeof(data), range_meters, time_rec);
   }
 
   LOG_VERBOSE(wxT("emulating %d spokes at range %d with %d spots"), scanlines_in_packet, range_meters, spots);
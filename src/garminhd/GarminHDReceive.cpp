@@ -87,6 +87,7 @@ void GarminHDReceive::ProcessFrame(radar_line *packet) {
   uint8_t line[GARMIN_HD_MAX_SPOKE_LEN];
   int i;
   uint8_t *p, *s;
+  LatencyTimer timer(m_ri->m_latency, LATENCY_DECODE);
 
   if (packet->scan_length * 2 > GARMIN_HD_MAX_SPOKE_LEN) {
     LOG_INFO(wxT("%s truncating data, %d longer than expected max length %d"), packet->scan_length * 8, GARMIN_HD_MAX_SPOKE_LEN);
@@ -122,8 +123,6 @@ void GarminHDReceive::ProcessFrame(radar_line *packet) {
     wxLongLong startup_elapsed = wxGetUTCTimeMillis() - m_pi->GetBootMillis();
     LOG_INFO(wxT("%s first radar spoke received after %llu ms\n"), m_ri->m_name.c_str(), startup_elapsed);
   }
-  wxCriticalSectionLocker lock(m_ri->m_exclusive);
-
   for (int j = 0; j < 4; j++) {
     s = &packet->line_data[packet->scan_length / 4 * j];
     for (p = line, i = 0; i < packet->scan_length / 4; i++, s++) {
@@ -148,7 +147,7 @@ void GarminHDReceive::ProcessFrame(radar_line *packet) {
     SpokeBearing a = MOD_SPOKES(angle_raw);
     SpokeBearing b = MOD_SPOKES(bearing_raw);
 
-    m_ri->ProcessRadarSpoke(a, b, line, p - line, packet->display_meters, time_rec);
+    m_ri->QueueRadarSpoke(a, b, line, p - line, packet->display_meters, time_rec);
 
     angle_raw++;
     spoke++;
@@ -315,6 +314,7 @@ void *GarminHDReceive::Entry(void) {
         rx_len = sizeof(rx_addr);
         r = recvfrom(reportSocket, (char *)data, sizeof(data), 0, (struct sockaddr *)&rx_addr, &rx_len);
         if (r > 0) {
+          RecordPacket(PACKET_REPORT, data, r);
           NetworkAddress radar_address;
           radar_address.addr = rx_addr.ipv4.sin_addr;
           radar_address.port = rx_addr.ipv4.sin_port;
@@ -602,6 +602,17 @@ bool GarminHDReceive::ProcessReport(const uint8_t *report, size_t len) {
   return false;
 }
 
+// Called from ReplayReceive with a packet that was recorded in Entry().
+void GarminHDReceive::ReplayPacket(PacketChannel channel, const uint8_t *data, size_t len) {
+  switch (channel) {
+    case PACKET_REPORT:
+      ProcessReport(data, len);
+      break;
+    default:
+      break;
+  }
+}
+
 // Called from the main thread to stop this thread.
 // We send a simple one byte message to the thread so that it awakens from the select() call with
 // this message ready for it to be read on 'm_receive_socket'. See the constructor in GarminHDReceive.h
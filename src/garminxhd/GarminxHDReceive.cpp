@@ -78,11 +78,10 @@ void GarminxHDReceive::ProcessFrame(const uint8_t *data, size_t len) {
   // log_line.time_rec = wxGetUTCTimeMillis();
   wxLongLong time_rec = wxGetUTCTimeMillis();
   time_t now = (time_t)(time_rec.GetValue() / MILLISECONDS_PER_SECOND);
+  LatencyTimer timer(m_ri->m_latency, LATENCY_DECODE);
 
   radar_line *packet = (radar_line *)data;
 
-  wxCriticalSectionLocker lock(m_ri->m_exclusive);
-
   m_ri->m_radar_timeout = now + WATCHDOG_TIMEOUT;
   m_ri->m_data_timeout = now + DATA_TIMEOUT;
   m_ri->m_state.Update(RADAR_TRANSMIT);
@@ -125,7 +124,7 @@ void GarminxHDReceive::ProcessFrame(const uint8_t *data, size_t len) {
   SpokeBearing b = MOD_SPOKES(bearing_raw);
 
   m_ri->m_range.Update(packet->range_meters);
-  m_ri->ProcessRadarSpoke(a, b, packet->line_data, len, packet->display_meters, time_rec);
+  m_ri->QueueRadarSpoke(a, b, packet->line_data, len, packet->display_meters, time_rec);
 }
 
 // Check that this interface is valid for
@@ -330,6 +329,7 @@ void *GarminxHDReceive::Entry(void) {
         rx_len = sizeof(rx_addr);
         r = recvfrom(dataSocket, (char *)data, sizeof(data), 0, (struct sockaddr *)&rx_addr, &rx_len);
         if (r > 0) {
+          RecordPacket(PACKET_DATA, data, r);
           ProcessFrame(data, (size_t)r);
           no_data_timeout = -15;
           no_spoke_timeout = -5;
@@ -344,6 +344,7 @@ void *GarminxHDReceive::Entry(void) {
         rx_len = sizeof(rx_addr);
         r = recvfrom(reportSocket, (char *)data, sizeof(data), 0, (struct sockaddr *)&rx_addr, &rx_len);
         if (r > 0) {
+          RecordPacket(PACKET_REPORT, data, r);
           NetworkAddress radar_address;
           radar_address.addr = rx_addr.ipv4.sin_addr;
           radar_address.port = rx_addr.ipv4.sin_port;
@@ -776,6 +777,20 @@ bool GarminxHDReceive::ProcessReport(const uint8_t *report, size_t len) {
   return false;
 }
 
+// Called from ReplayReceive with a packet that was recorded in Entry().
+void GarminxHDReceive::ReplayPacket(PacketChannel channel, const uint8_t *data, size_t len) {
+  switch (channel) {
+    case PACKET_DATA:
+      ProcessFrame(data, len);
+      break;
+    case PACKET_REPORT:
+      ProcessReport(data, len);
+      break;
+    default:
+      break;
+  }
+}
+
 // Called from the main thread to stop this thread.
 // We send a simple one byte message to the thread so that it awakens from the select() call with
 // this message ready for it to be read on 'm_receive_socket'. See the constructor in GarminxHDReceive.h
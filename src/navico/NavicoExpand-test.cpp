@@ -0,0 +1,115 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "NavicoExpand.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+static const char *DopplerName[3] = {"normal", "both", "approaching"};
+
+// The expansion as it was done in NavicoReceive::ProcessFrame before the vector kernels
+static void ExpandReference(const uint8_t *packed, uint8_t *out, size_t packed_len, int doppler) {
+  uint8_t *lookup_low = lookupData[LOOKUP_SPOKE_LOW_NORMAL + doppler];
+  uint8_t *lookup_high = lookupData[LOOKUP_SPOKE_HIGH_NORMAL + doppler];
+  for (size_t i = 0; i < packed_len; i++) {
+    out[2 * i] = lookup_low[packed[i]];
+    out[2 * i + 1] = lookup_high[packed[i]];
+  }
+}
+
+static int CompareKernel(NavicoExpandKernel kernel, const uint8_t *packed, size_t len, int doppler) {
+  uint8_t expected[2 * 1024 + 64];
+  uint8_t actual[2 * 1024 + 64];
+
+  memset(expected, 0xaa, sizeof(expected));
+  memset(actual, 0xaa, sizeof(actual));
+  ExpandReference(packed, expected, len, doppler);
+  NavicoExpandSpokeWith(kernel, packed, actual, len, doppler);
+
+  // Also compare the bytes beyond 2 * len to catch writes past the end
+  for (size_t i = 0; i < sizeof(expected); i++) {
+    if (expected[i] != actual[i]) {
+      cout << "ERROR: " << NavicoExpandKernelName(kernel) << " doppler " << DopplerName[doppler] << " len " << len << " differs at "
+           << i << ": expected " << (int)expected[i] << " got " << (int)actual[i] << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int NavicoExpandTest() {
+  int ret = 0;
+  uint8_t packed[1024 + 16];
+
+  NavicoInitializeLookupData();
+
+  for (int k = 0; k < NAVICO_EXPAND_KERNELS; k++) {
+    NavicoExpandKernel kernel = (NavicoExpandKernel)k;
+    uint8_t dummy[2];
+
+    if (!NavicoExpandSpokeWith(kernel, packed, dummy, 0, 0)) {
+      cout << "INFO: " << NavicoExpandKernelName(kernel) << " not available\n";
+      continue;
+    }
+    cout << "INFO: testing " << NavicoExpandKernelName(kernel) << "\n";
+
+    for (int doppler = 0; doppler < 3; doppler++) {
+      // Every possible byte value, in a full Navico spoke
+      for (int i = 0; i < 512; i++) {
+        packed[i] = (uint8_t)i;
+      }
+      ret |= CompareKernel(kernel, packed, 512, doppler);
+
+      // Random data at all lengths and alignments, to exercise the tail handling
+      srand(doppler + 1);
+      for (size_t len = 0; len <= 100; len++) {
+        for (size_t offset = 0; offset < 16; offset++) {
+          for (size_t i = 0; i < len; i++) {
+            packed[offset + i] = (uint8_t)rand();
+          }
+          ret |= CompareKernel(kernel, packed + offset, len, doppler);
+        }
+      }
+    }
+  }
+
+  if (ret == 0) {
+    cout << "INFO: all kernels match lookupData\n";
+  }
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main() { return PLUGIN_NAMESPACE::NavicoExpandTest(); }
@@ -0,0 +1,336 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "NavicoExpand.h"
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define NAVICO_HAVE_SSSE3
+#include <tmmintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+// MSVC never defines __SSSE3__, but always has the intrinsics on x64; the CPU is checked with __cpuid.
+#define NAVICO_HAVE_SSSE3
+#define NAVICO_CHECK_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NAVICO_HAVE_AVX2
+#define NAVICO_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define NAVICO_HAVE_AVX2
+#define NAVICO_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define NAVICO_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+PLUGIN_BEGIN_NAMESPACE
+
+uint8_t lookupData[6][256];
+
+// Per nibble version of lookupData, for doppler mode normal, both and approaching
+static uint8_t lookupNibble[3][16];
+
+// Make space for BLOB_HISTORY_COLORS
+static const uint8_t lookupNibbleToByte[16] = {
+    0,     // 0
+    0x32,  // 1
+    0x40,  // 2
+    0x4e,  // 3
+    0x5c,  // 4
+    0x6a,  // 5
+    0x78,  // 6
+    0x86,  // 7
+    0x94,  // 8
+    0xa2,  // 9
+    0xb0,  // a
+    0xbe,  // b
+    0xcc,  // c
+    0xda,  // d
+    0xe8,  // e
+    0xf4,  // f
+};
+
+void NavicoInitializeLookupData() {
+  if (lookupData[5][255] == 0) {
+    for (int j = 0; j <= UINT8_MAX; j++) {
+      uint8_t low = lookupNibbleToByte[(j & 0x0f)];
+      uint8_t high = lookupNibbleToByte[(j & 0xf0) >> 4];
+
+      lookupData[LOOKUP_SPOKE_LOW_NORMAL][j] = (uint8_t)low;
+      lookupData[LOOKUP_SPOKE_HIGH_NORMAL][j] = (uint8_t)high;
+
+      switch (low) {
+        case 0xf4:
+          lookupData[LOOKUP_SPOKE_LOW_BOTH][j] = 0xff;
+          lookupData[LOOKUP_SPOKE_LOW_APPROACHING][j] = 0xff;
+          break;
+
+        case 0xe8:
+          lookupData[LOOKUP_SPOKE_LOW_BOTH][j] = 0xfe;
+          lookupData[LOOKUP_SPOKE_LOW_APPROACHING][j] = (uint8_t)low;
+          break;
+
+        default:
+          lookupData[LOOKUP_SPOKE_LOW_BOTH][j] = (uint8_t)low;
+          lookupData[LOOKUP_SPOKE_LOW_APPROACHING][j] = (uint8_t)low;
+      }
+
+      switch (high) {
+        case 0xf4:
+          lookupData[LOOKUP_SPOKE_HIGH_BOTH][j] = 0xff;
+          lookupData[LOOKUP_SPOKE_HIGH_APPROACHING][j] = 0xff;
+          break;
+
+        case 0xe8:
+          lookupData[LOOKUP_SPOKE_HIGH_BOTH][j] = 0xfe;
+          lookupData[LOOKUP_SPOKE_HIGH_APPROACHING][j] = (uint8_t)high;
+          break;
+
+        default:
+          lookupData[LOOKUP_SPOKE_HIGH_BOTH][j] = (uint8_t)high;
+          lookupData[LOOKUP_SPOKE_HIGH_APPROACHING][j] = (uint8_t)high;
+      }
+    }
+
+    // The low nibble of j < 16 is j itself, so row LOW_xxx holds the nibble table
+    for (int doppler = 0; doppler < 3; doppler++) {
+      for (int n = 0; n < 16; n++) {
+        lookupNibble[doppler][n] = lookupData[LOOKUP_SPOKE_LOW_NORMAL + doppler][n];
+      }
+    }
+  }
+}
+
+static void ExpandScalar(const uint8_t *packed, uint8_t *out, size_t packed_len, int doppler) {
+  const uint8_t *lookup_low = lookupData[LOOKUP_SPOKE_LOW_NORMAL + doppler];
+  const uint8_t *lookup_high = lookupData[LOOKUP_SPOKE_HIGH_NORMAL + doppler];
+
+  for (size_t i = 0; i < packed_len; i++) {
+    out[2 * i] = lookup_low[packed[i]];
+    out[2 * i + 1] = lookup_high[packed[i]];
+  }
+}
+
+// Used by the vector kernels for the last (packed_len % vector size) bytes
+static void ExpandTail(const uint8_t *packed, uint8_t *out, size_t start, size_t packed_len, int doppler) {
+  const uint8_t *nibble = lookupNibble[doppler];
+
+  for (size_t i = start; i < packed_len; i++) {
+    out[2 * i] = nibble[packed[i] & 0x0f];
+    out[2 * i + 1] = nibble[packed[i] >> 4];
+  }
+}
+
+#ifdef NAVICO_HAVE_SSSE3
+static void ExpandSSSE3(const uint8_t *packed, uint8_t *out, size_t packed_len, int doppler) {
+  const __m128i table = _mm_loadu_si128((const __m128i *)lookupNibble[doppler]);
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+
+  for (; i + 16 <= packed_len; i += 16) {
+    __m128i in = _mm_loadu_si128((const __m128i *)(packed + i));
+    __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(in, mask));
+    __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+    _mm_storeu_si128((__m128i *)(out + 2 * i), _mm_unpacklo_epi8(lo, hi));
+    _mm_storeu_si128((__m128i *)(out + 2 * i + 16), _mm_unpackhi_epi8(lo, hi));
+  }
+  ExpandTail(packed, out, i, packed_len, doppler);
+}
+#endif
+
+#ifdef NAVICO_CHECK_SSSE3
+static bool HaveSSSE3() {
+  static int have = -1;
+  if (have < 0) {
+    int info[4];
+    __cpuid(info, 1);
+    have = (info[2] >> 9) & 1;  // ECX bit 9
+  }
+  return have == 1;
+}
+#endif
+
+#ifdef NAVICO_HAVE_AVX2
+NAVICO_TARGET_AVX2 static void ExpandAVX2(const uint8_t *packed, uint8_t *out, size_t packed_len, int doppler) {
+  const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)lookupNibble[doppler]));
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+
+  for (; i + 32 <= packed_len; i += 32) {
+    __m256i in = _mm256_loadu_si256((const __m256i *)(packed + i));
+    __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(in, mask));
+    __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+    // unpack works per 128 bit lane, so the result is [0..7 16..23] and [8..15 24..31]
+    __m256i a = _mm256_unpacklo_epi8(lo, hi);
+    __m256i b = _mm256_unpackhi_epi8(lo, hi);
+    _mm256_storeu_si256((__m256i *)(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256((__m256i *)(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+  }
+  ExpandTail(packed, out, i, packed_len, doppler);
+}
+
+static bool HaveAVX2() {
+  static int have = -1;
+  if (have < 0) {
+#ifdef _MSC_VER
+    // AVX2 is leaf 7 EBX bit 5, and only usable when the OS saves the YMM registers (OSXSAVE, XCR0 bits 1 and 2)
+    int info[4];
+    have = 0;
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+      __cpuid(info, 1);
+      if ((info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        have = (info[1] >> 5) & 1;
+      }
+    }
+#else
+    __builtin_cpu_init();
+    have = __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+  }
+  return have == 1;
+}
+#endif
+
+#ifdef NAVICO_HAVE_NEON
+static void ExpandNEON(const uint8_t *packed, uint8_t *out, size_t packed_len, int doppler) {
+  const uint8x16_t mask = vdupq_n_u8(0x0f);
+  size_t i = 0;
+
+#if defined(__aarch64__)
+  const uint8x16_t table = vld1q_u8(lookupNibble[doppler]);
+
+  for (; i + 16 <= packed_len; i += 16) {
+    uint8x16_t in = vld1q_u8(packed + i);
+    uint8x16x2_t result;
+    result.val[0] = vqtbl1q_u8(table, vandq_u8(in, mask));
+    result.val[1] = vqtbl1q_u8(table, vshrq_n_u8(in, 4));
+    vst2q_u8(out + 2 * i, result);  // vst2 interleaves lo and hi
+  }
+#else
+  uint8x8x2_t table;
+  table.val[0] = vld1_u8(lookupNibble[doppler]);
+  table.val[1] = vld1_u8(lookupNibble[doppler] + 8);
+
+  for (; i + 16 <= packed_len; i += 16) {
+    uint8x16_t in = vld1q_u8(packed + i);
+    uint8x16_t lo = vandq_u8(in, mask);
+    uint8x16_t hi = vshrq_n_u8(in, 4);
+    uint8x16x2_t result;
+    result.val[0] = vcombine_u8(vtbl2_u8(table, vget_low_u8(lo)), vtbl2_u8(table, vget_high_u8(lo)));
+    result.val[1] = vcombine_u8(vtbl2_u8(table, vget_low_u8(hi)), vtbl2_u8(table, vget_high_u8(hi)));
+    vst2q_u8(out + 2 * i, result);
+  }
+#endif
+  ExpandTail(packed, out, i, packed_len, doppler);
+}
+#endif
+
+bool NavicoExpandSpokeWith(NavicoExpandKernel kernel, const uint8_t *packed, uint8_t *out, size_t packed_len, int doppler) {
+  if (doppler < 0 || doppler > 2) {
+    doppler = 0;
+  }
+  switch (kernel) {
+    case NAVICO_EXPAND_SCALAR:
+      ExpandScalar(packed, out, packed_len, doppler);
+      return true;
+
+#ifdef NAVICO_HAVE_SSSE3
+    case NAVICO_EXPAND_SSSE3:
+#ifdef NAVICO_CHECK_SSSE3
+      if (!HaveSSSE3()) {
+        return false;
+      }
+#endif
+      ExpandSSSE3(packed, out, packed_len, doppler);
+      return true;
+#endif
+
+#ifdef NAVICO_HAVE_AVX2
+    case NAVICO_EXPAND_AVX2:
+      if (!HaveAVX2()) {
+        return false;
+      }
+      ExpandAVX2(packed, out, packed_len, doppler);
+      return true;
+#endif
+
+#ifdef NAVICO_HAVE_NEON
+    case NAVICO_EXPAND_NEON:
+      ExpandNEON(packed, out, packed_len, doppler);
+      return true;
+#endif
+
+    default:
+      return false;
+  }
+}
+
+NavicoExpandKernel NavicoExpandBestKernel() {
+#ifdef NAVICO_HAVE_AVX2
+  if (HaveAVX2()) {
+    return NAVICO_EXPAND_AVX2;
+  }
+#endif
+#if defined(NAVICO_CHECK_SSSE3)
+  return HaveSSSE3() ? NAVICO_EXPAND_SSSE3 : NAVICO_EXPAND_SCALAR;
+#elif defined(NAVICO_HAVE_SSSE3)
+  return NAVICO_EXPAND_SSSE3;
+#elif defined(NAVICO_HAVE_NEON)
+  return NAVICO_EXPAND_NEON;
+#else
+  return NAVICO_EXPAND_SCALAR;
+#endif
+}
+
+void NavicoExpandSpoke(const uint8_t *packed, uint8_t *out, size_t packed_len, int doppler) {
+  static const NavicoExpandKernel kernel = NavicoExpandBestKernel();
+
+  NavicoExpandSpokeWith(kernel, packed, out, packed_len, doppler);
+}
+
+const char *NavicoExpandKernelName(NavicoExpandKernel kernel) {
+  static const char *names[NAVICO_EXPAND_KERNELS] = {"scalar", "SSSE3", "AVX2", "NEON"};
+
+  return kernel < NAVICO_EXPAND_KERNELS ? names[kernel] : "unknown";
+}
+
+PLUGIN_END_NAMESPACE
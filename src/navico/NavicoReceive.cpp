@@ -34,6 +34,7 @@
 
 #include "MessageBox.h"
 #include "NavicoControl.h"
+#include "NavicoExpand.h"
 
 PLUGIN_BEGIN_NAMESPACE
 
@@ -189,79 +190,9 @@ struct radar_frame_pkt {
 };
 #pragma pack(pop)
 
-enum LookupSpokeEnum {
-  LOOKUP_SPOKE_LOW_NORMAL,
-  LOOKUP_SPOKE_LOW_BOTH,
-  LOOKUP_SPOKE_LOW_APPROACHING,
-  LOOKUP_SPOKE_HIGH_NORMAL,
-  LOOKUP_SPOKE_HIGH_BOTH,
-  LOOKUP_SPOKE_HIGH_APPROACHING
-};
-
-static uint8_t lookupData[6][256];
-
-// Make space for BLOB_HISTORY_COLORS
-static const uint8_t lookupNibbleToByte[16] = {
-    0,     // 0
-    0x32,  // 1
-    0x40,  // 2
-    0x4e,  // 3
-    0x5c,  // 4
-    0x6a,  // 5
-    0x78,  // 6
-    0x86,  // 7
-    0x94,  // 8
-    0xa2,  // 9
-    0xb0,  // a
-    0xbe,  // b
-    0xcc,  // c
-    0xda,  // d
-    0xe8,  // e
-    0xf4,  // f
-};
-
 void NavicoReceive::InitializeLookupData() {
-  if (lookupData[5][255] == 0) {
-    for (int j = 0; j <= UINT8_MAX; j++) {
-      uint8_t low = lookupNibbleToByte[(j & 0x0f)];
-      uint8_t high = lookupNibbleToByte[(j & 0xf0) >> 4];
-
-      lookupData[LOOKUP_SPOKE_LOW_NORMAL][j] = (uint8_t)low;
-      lookupData[LOOKUP_SPOKE_HIGH_NORMAL][j] = (uint8_t)high;
-
-      switch (low) {
-        case 0xf4:
-          lookupData[LOOKUP_SPOKE_LOW_BOTH][j] = 0xff;
-          lookupData[LOOKUP_SPOKE_LOW_APPROACHING][j] = 0xff;
-          break;
-
-        case 0xe8:
-          lookupData[LOOKUP_SPOKE_LOW_BOTH][j] = 0xfe;
-          lookupData[LOOKUP_SPOKE_LOW_APPROACHING][j] = (uint8_t)low;
-          break;
-
-        default:
-          lookupData[LOOKUP_SPOKE_LOW_BOTH][j] = (uint8_t)low;
-          lookupData[LOOKUP_SPOKE_LOW_APPROACHING][j] = (uint8_t)low;
-      }
-
-      switch (high) {
-        case 0xf4:
-          lookupData[LOOKUP_SPOKE_HIGH_BOTH][j] = 0xff;
-          lookupData[LOOKUP_SPOKE_HIGH_APPROACHING][j] = 0xff;
-          break;
-
-        case 0xe8:
-          lookupData[LOOKUP_SPOKE_HIGH_BOTH][j] = 0xfe;
-          lookupData[LOOKUP_SPOKE_HIGH_APPROACHING][j] = (uint8_t)high;
-          break;
-
-        default:
-          lookupData[LOOKUP_SPOKE_HIGH_BOTH][j] = (uint8_t)high;
-          lookupData[LOOKUP_SPOKE_HIGH_APPROACHING][j] = (uint8_t)high;
-      }
-    }
-  }
+  NavicoInitializeLookupData();
+  LOG_VERBOSE(wxT("%s spoke expansion uses %s"), m_ri->m_name.c_str(), NavicoExpandKernelName(NavicoExpandBestKernel()));
 }
 
 // ProcessFrame
@@ -274,11 +205,10 @@ void NavicoReceive::ProcessFrame(const uint8_t *data, size_t len) {
 
   // log_line.time_rec = wxGetUTCTimeMillis();
   wxLongLong time_rec = wxGetUTCTimeMillis();
+  LatencyTimer timer(m_ri->m_latency, LATENCY_DECODE);
 
   radar_frame_pkt *packet = (radar_frame_pkt *)data;
 
-  wxCriticalSectionLocker lock(m_ri->m_exclusive);
-
   m_ri->m_radar_timeout = now + WATCHDOG_TIMEOUT;
   m_ri->m_data_timeout = now + DATA_TIMEOUT;
   m_ri->m_state.Update(RADAR_TRANSMIT);
@@ -420,13 +350,8 @@ void NavicoReceive::ProcessFrame(const uint8_t *data, size_t len) {
     if (doppler < 0 || doppler > 2) {
       doppler = 0;
     }
-    uint8_t *lookup_low = lookupData[LOOKUP_SPOKE_LOW_NORMAL + doppler];
-    uint8_t *lookup_high = lookupData[LOOKUP_SPOKE_HIGH_NORMAL + doppler];
-    for (int i = 0; i < NAVICO_SPOKE_LEN / 2; i++) {
-      data_highres[2 * i] = lookup_low[line->data[i]];
-      data_highres[2 * i + 1] = lookup_high[line->data[i]];
-    }
-    m_ri->ProcessRadarSpoke(a, b, data_highres, len, range_meters, time_rec);
+    NavicoExpandSpoke(line->data, data_highres, NAVICO_SPOKE_LEN / 2, doppler);
+    m_ri->QueueRadarSpoke(a, b, data_highres, len, range_meters, time_rec);
   }
 }
 
@@ -751,6 +676,7 @@ void *NavicoReceive::Entry(void) {
         rx_len = sizeof(rx_addr);
         r = recvfrom(dataSocket, (char *)data, sizeof(data), 0, (struct sockaddr *)&rx_addr, &rx_len);
         if (r > 0) {
+          RecordPacket(PACKET_DATA, data, r);
           ProcessFrame(data, (size_t)r);
           no_data_timeout = -15;
           no_spoke_timeout = -5;
@@ -765,6 +691,7 @@ void *NavicoReceive::Entry(void) {
         rx_len = sizeof(rx_addr);
         r = recvfrom(reportSocket, (char *)data, sizeof(data), 0, (struct sockaddr *)&rx_addr, &rx_len);
         if (r > 0) {
+          RecordPacket(PACKET_REPORT, data, r);
           if (ProcessReport(data, (size_t)r)) {
             if (radar_address.IsNull()) {
               radar_address.addr = rx_addr.ipv4.sin_addr;
@@ -1444,6 +1371,20 @@ bool NavicoReceive::ProcessReport(const uint8_t *report, size_t len) {
   return false;
 }
 
+// Called from ReplayReceive with a packet that was recorded in Entry().
+void NavicoReceive::ReplayPacket(PacketChannel channel, const uint8_t *data, size_t len) {
+  switch (channel) {
+    case PACKET_DATA:
+      ProcessFrame(data, len);
+      break;
+    case PACKET_REPORT:
+      ProcessReport(data, len);
+      break;
+    default:
+      break;
+  }
+}
+
 // Called from the main thread to stop this thread.
 // We send a simple one byte message to the thread so that it awakens from the select() call with
 // this message ready for it to be read on 'm_receive_socket'. See the constructor in NavicoReceive.h
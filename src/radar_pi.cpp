@@ -42,6 +42,7 @@
 #include "MessageBox.h"
 #include "OptionsDialog.h"
 #include "SelectDialog.h"
+#include "SpokeQueue.h"
 #include "icons.h"
 #include "navico/NavicoLocate.h"
 #include "nmea0183.h"
@@ -61,9 +62,11 @@ int g_verbose;
 
 // the class factories, used to create and destroy instances of the PlugIn
 
+#ifndef RADAR_BENCH
 extern "C" DECL_EXP opencpn_plugin *create_pi(void *ppimgr) { return new radar_pi(ppimgr); }
 
 extern "C" DECL_EXP void destroy_pi(opencpn_plugin *p) { delete p; }
+#endif
 
 /********************************************************************************************************/
 //   Distance measurement for simple sphere
@@ -160,16 +163,24 @@ END_EVENT_TABLE()
 //
 //---------------------------------------------------------------------------------------------------------
 
+#ifdef RADAR_BENCH
+radar_pi::radar_pi(void *ppimgr) : m_raymarine_locator(0) {
+#else
 radar_pi::radar_pi(void *ppimgr) : opencpn_plugin_119(ppimgr), m_raymarine_locator(0) {
+#endif
   m_boot_time = wxGetUTCTimeMillis();
   m_initialized = false;
   m_predicted_position_initialised = false;
 
   M_SETTINGS = {0};
 
+#ifdef RADAR_BENCH
+  m_pdeficon = 0;  // Bitmaps need a display
+#else
   // Create the PlugIn icons
   initialize_images();
   m_pdeficon = new wxBitmap(*_img_radar_blank);
+#endif
 
   m_opengl_mode = OPENGL_UNKOWN;
   m_opengl_mode_changed = false;
@@ -1175,6 +1186,20 @@ void radar_pi::TimedControlUpdate() {
                               m_radar[r]->m_statistics.packets, m_radar[r]->m_statistics.broken_packets,
                               m_radar[r]->m_statistics.spokes, m_radar[r]->m_statistics.broken_spokes,
                               m_radar[r]->m_statistics.missing_spokes);
+        if (m_radar[r]->m_spoke_queue) {
+          m_radar[r]->m_spoke_queue->GetStatistics(&m_radar[r]->m_statistics);
+          t << wxString::Format(wxT("queue %d/%d/%d dropped %d\n"), m_radar[r]->m_statistics.queue_depth,
+                                m_radar[r]->m_statistics.queue_high_water, (int)m_radar[r]->m_spoke_queue->GetCapacity(),
+                                m_radar[r]->m_statistics.queue_dropped);
+        }
+        if (m_radar[r]->m_latency.IsEnabled()) {
+          t << wxT("latency p50/p99/max\n") << m_radar[r]->m_latency.GetText();
+        }
+        if (m_radar[r]->m_polar_lookup) {
+          t << wxString::Format(wxT("polar lookup %d kB, %d radars\n"), (int)(m_radar[r]->m_polar_lookup->GetMemoryUsed() / 1024),
+                                m_radar[r]->m_polar_lookup->GetUsers());
+        }
+        t << m_radar[r]->GetDrawStatistics();
         if (m_radar[r]->m_radar_type == RM_E120) {
           t << wxString::Format(wxT("Magnetron current %d\n"), m_radar[r]->m_magnetron_current.GetValue());
           double mag_hours = (double)m_radar[r]->m_magnetron_time.GetValue() / 10.;
@@ -1211,6 +1236,9 @@ void radar_pi::TimedControlUpdate() {
     m_radar[r]->m_statistics.missing_spokes = 0;
     m_radar[r]->m_statistics.packets = 0;
     m_radar[r]->m_statistics.spokes = 0;
+    if (m_radar[r]->m_spoke_queue) {
+      m_radar[r]->m_spoke_queue->ResetStatistics();
+    }
   }
 
   wxString info;
@@ -1709,8 +1737,16 @@ bool radar_pi::LoadConfig(void) {
     pConf->Read(wxT("PassHeadingToOCPN"), &m_settings.pass_heading_to_opencpn, false);
     pConf->Read(wxT("Refreshrate"), &v, 3);
     m_settings.refreshrate.Update(v);
+    pConf->Read(wxT("CapturePackets"), &m_settings.capture_packets, 64);
+    pConf->Read(wxT("MergeVertexBlobs"), &m_settings.merge_vertex_blobs, true);
+    pConf->Read(wxT("PinProcessThreads"), &m_settings.pin_process_threads, false);
+    pConf->Read(wxT("ProcessThreads"), &m_settings.process_threads, 0);
+    pConf->Read(wxT("RecordFile"), &m_settings.record_file, wxEmptyString);
+    pConf->Read(wxT("ReplayFile"), &m_settings.replay_file, wxEmptyString);
+    pConf->Read(wxT("ReplayRealtime"), &m_settings.replay_realtime, true);
     pConf->Read(wxT("ReverseZoom"), &m_settings.reverse_zoom, false);
     pConf->Read(wxT("ScanMaxAge"), &m_settings.max_age, 6);
+    pConf->Read(wxT("ShaderSmoothing"), &m_settings.shader_smoothing, false);
     pConf->Read(wxT("Show"), &m_settings.show, true);
     pConf->Read(wxT("SkewFactor"), &m_settings.skew_factor, 1);
     pConf->Read(wxT("ThresholdBlue"), &m_settings.threshold_blue, 32);
@@ -1758,8 +1794,16 @@ bool radar_pi::SaveConfig(void) {
     pConf->Write(wxT("PassHeadingToOCPN"), m_settings.pass_heading_to_opencpn);
     pConf->Write(wxT("RangeUnits"), (int)m_settings.range_units);
     pConf->Write(wxT("Refreshrate"), m_settings.refreshrate.GetValue());
+    pConf->Write(wxT("CapturePackets"), m_settings.capture_packets);
+    pConf->Write(wxT("MergeVertexBlobs"), m_settings.merge_vertex_blobs);
+    pConf->Write(wxT("PinProcessThreads"), m_settings.pin_process_threads);
+    pConf->Write(wxT("ProcessThreads"), m_settings.process_threads);
+    pConf->Write(wxT("RecordFile"), m_settings.record_file);
+    pConf->Write(wxT("ReplayFile"), m_settings.replay_file);
+    pConf->Write(wxT("ReplayRealtime"), m_settings.replay_realtime);
     pConf->Write(wxT("ReverseZoom"), m_settings.reverse_zoom);
     pConf->Write(wxT("ScanMaxAge"), m_settings.max_age);
+    pConf->Write(wxT("ShaderSmoothing"), m_settings.shader_smoothing);
     pConf->Write(wxT("Show"), m_settings.show);
     pConf->Write(wxT("SkewFactor"), m_settings.skew_factor);
     pConf->Write(wxT("ThresholdBlue"), m_settings.threshold_blue);
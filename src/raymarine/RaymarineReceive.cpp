@@ -37,7 +37,9 @@
 #include "RaymarineReceive.h"
 
 #include "MessageBox.h"
+#include "PacketCapture.h"
 #include "RME120Control.h"
+#include "RaymarineUnpack.h"
 
 PLUGIN_BEGIN_NAMESPACE
 
@@ -247,6 +249,7 @@ void *RaymarineReceive::Entry(void) {
         rx_len = sizeof(rx_addr);
         r = recvfrom(m_comm_socket, (char *)data, sizeof(data), 0, (struct sockaddr *)&rx_addr, &rx_len);
         if (r > 0) {
+          RecordPacket(PACKET_DATA, data, r);
           NetworkAddress radar_address;
           radar_address.addr = rx_addr.ipv4.sin_addr;
           radar_address.port = rx_addr.ipv4.sin_port;
@@ -354,6 +357,9 @@ void RaymarineReceive::ProcessFrame(const UINT8 *data, size_t len) {  // This is
   int status;
   wxString stat;
   // LOG_BINARY_RECEIVE(wxT("received frame"), data, len);
+  if (m_ri->m_capture) {
+    m_ri->m_capture->Capture(data, len);
+  }
   m_ri->resetTimeout(now);
   m_ri->m_radar_timeout = now + WATCHDOG_TIMEOUT;
   m_ri->m_statistics.packets++;
@@ -897,11 +903,13 @@ struct SpokeData {
 };
 
 void RaymarineReceive::ProcessScanData(const UINT8 *data, int len) {
+  LatencyTimer timer(m_ri->m_latency, LATENCY_DECODE);
+
   if (m_range_meters == 1) {
     LOG_RECEIVE(wxT("Invalid range"));
     return;
   }
-  m_pi->logBinaryData(wxT("Scandata"), data, len);
+  LOG_BINARY_RECEIVE(wxT("Scandata"), data, len);
   if (len > (int)(sizeof(Header1) + sizeof(Header3))) {
     Header1 *pHeader = (Header1 *)data;
     bool HDtype = false;
@@ -925,7 +933,7 @@ void RaymarineReceive::ProcessScanData(const UINT8 *data, int len) {
     int headerIdx = 0;
     int nextOffset = sizeof(Header1);
 
-    while (nextOffset < len) {
+    while (nextOffset >= 0 && nextOffset + (int)(sizeof(Header3) + sizeof(Header2)) <= len) {
       Header3 *sHeader = (Header3 *)(data + nextOffset);
       if (sHeader->field01 != 0x00000001 || sHeader->length != 0x00000028) {
         LOG_RECEIVE(wxT("ProcessScanData::Scan header #%d (%d) - %x, %x.\n"), headerIdx, nextOffset, sHeader->field01,
@@ -954,6 +962,10 @@ void RaymarineReceive::ProcessScanData(const UINT8 *data, int len) {
         }
         nextOffset += nHeader->length;
       }
+      if (nextOffset < 0 || nextOffset + (int)sizeof(SpokeData) > len) {
+        LOG_RECEIVE(wxT("ProcessScanData::Scan data header #%d beyond end of packet.\n"), headerIdx);
+        break;
+      }
       SpokeData *pSData = (SpokeData *)(data + nextOffset);
       if ((pSData->field01 & 0x7fffffff) != 0x00000003 || pSData->length < pSData->data_len + 8) {
         LOG_RECEIVE(wxT("ProcessScanData::Scan data header #%d check failed %x, %d, %d.\n"), headerIdx, pSData->field01,
@@ -962,69 +974,13 @@ void RaymarineReceive::ProcessScanData(const UINT8 *data, int len) {
       }
       UINT8 unpacked_data[10240], *dataPtr = 0;
 
-      uint8_t *dData = (uint8_t *)unpacked_data;
+      // The spoke data may not extend beyond the end of the packet, whatever the header says
+      size_t src_len = wxMin((size_t)pSData->length - 8, (size_t)(len - nextOffset) - sizeof(SpokeData));
       uint8_t *sData = (uint8_t *)data + nextOffset + sizeof(SpokeData);
 
-      unsigned int iS = 0;
-      unsigned int iD = 0;
       // LOG_BINARY_RECEIVE(wxT("spoke data sData"), sData, pSData->data_len);
-      while (iS < pSData->data_len) {
-        if (HDtype) {
-          if (iD >= 1024) {  // remove trailing zero's
-            break;
-          }
-          if (*sData != 0x5c) {
-            *dData++ = *sData;
-            sData++;
-            iS++;
-            iD++;
-          } else {
-            uint8_t nFill = sData[1];  // number to be filled
-            uint8_t cFill = sData[2];  // data to be filled
-            for (unsigned int i = 0; i < nFill; i++) {
-              *dData++ = cFill;
-            }
-            sData += 3;
-            iS += 3;
-            iD += nFill;
-          }
-        } else {  // not HDtype
-          if (*sData != 0x5c) {
-            *dData++ = (((*sData) & 0x0f) << 4) + 0x0f;
-            *dData++ = ((*sData) & 0xf0) + 0x0f;
-            sData++;
-            iS++;
-            iD += 2;
-          } else {
-            uint8_t nFill = sData[1];
-            uint8_t cFill = sData[2];
-
-            for (unsigned int i = 0; i < nFill; i++) {
-              *dData++ = ((cFill & 0x0f) << 4) + 0x0f;
-              *dData++ = (cFill & 0xf0) + 0x0f;
-            }
-            sData += 3;
-            iS += 3;
-            iD += nFill * 2;
-          }
-        }
-      }
-      if (iD != returns_per_line) {
-        while (iS < pSData->length - 8 && iD <= returns_per_line) {
-          if (HDtype) {
-            *dData++ = *sData;
-            sData++;
-            iS++;
-            iD++;
-          } else {
-            *dData++ = ((*sData) & 0x0f) << 4;
-            *dData++ = (*sData) & 0xf0;
-            sData++;
-            iS++;
-            iD += 2;
-          }
-        }
-      }
+      RaymarineUnpackSpoke(HDtype ? RM_SPOKE_BYTES : RM_SPOKE_NIBBLES, sData, pSData->data_len, src_len, unpacked_data,
+                           sizeof(unpacked_data), returns_per_line);
 
       // LOG_BINARY_RECEIVE(wxT("spoke data dData"), unpacked_data, pSData->data_len);
       dataPtr = unpacked_data;
@@ -1069,10 +1025,10 @@ void RaymarineReceive::ProcessScanData(const UINT8 *data, int len) {
       }
       /*LOG_INFO(wxT("ProcessRadarSpoke a=%i, angle_raw=%i b=%i, bearing_raw=%i, returns_per_line=%i range=%i spokes=%i"), angle,
          angle_raw, bearing, bearing_raw, returns_per_line, m_range_meters, m_ri->m_spokes);*/
-      m_ri->ProcessRadarSpoke(angle, bearing, dataPtr, returns_per_line, m_range_meters, nowMillis);
+      m_ri->QueueRadarSpoke(angle, bearing, dataPtr, returns_per_line, m_range_meters, nowMillis);
       // When te HD radar is transmitting in a mode with 1024 spokes, insert additional spokes to fill the image
       if (spokes_1024 && angle + 1 < (int)m_ri->m_spokes && bearing + 1 < (int)m_ri->m_spokes) {
-        m_ri->ProcessRadarSpoke(angle + 1, bearing + 1, dataPtr, returns_per_line, m_range_meters, nowMillis);
+        m_ri->QueueRadarSpoke(angle + 1, bearing + 1, dataPtr, returns_per_line, m_range_meters, nowMillis);
       }
     }
   }
@@ -1101,12 +1057,14 @@ struct SQuantumScanDataHeader {
 };
 
 void RaymarineReceive::ProcessQuantumScanData(const UINT8 *data, int len) {
+  LatencyTimer timer(m_ri->m_latency, LATENCY_DECODE);
+
   if (m_range_meters == 1) {
     LOG_RECEIVE(wxT("Invalid range"));
     return;
   }
   SQuantumScanDataHeader *qheader = (SQuantumScanDataHeader *)data;
-  m_pi->logBinaryData(wxT("SQuantumScanDataHeader"), data, len);
+  LOG_BINARY_RECEIVE(wxT("SQuantumScanDataHeader"), data, len);
   if (len > (int)(sizeof(SQuantumScanDataHeader))) {
     u_int returns_per_line;
 
@@ -1119,37 +1077,16 @@ void RaymarineReceive::ProcessQuantumScanData(const UINT8 *data, int len) {
     int nextOffset = sizeof(QuantumHeader);
     UINT8 unpacked_data[1024], *dataPtr = 0;
 
-    uint8_t *dData = (uint8_t *)unpacked_data;
-    uint8_t *sData = (uint8_t *)data + nextOffset;
-
-    unsigned int iS = 0;
-    unsigned int iD = 0;
-    while (iS < qheader->data_len) {
-      if (iD >= 1024) {  // remove trailing zero's
-        break;
-      }
-      if (*sData != 0x5c) {
-        *dData++ = *sData;
-        sData++;
-        iS++;
-        iD++;
-      } else {
-        uint8_t nFill = sData[1];  // number to be filled
-        uint8_t cFill = sData[2];  // data to be filled
-        for (unsigned int i = 0; i < nFill; i++) {
-          *dData++ = cFill;
-        }
-        sData += 3;
-        iS += 3;
-        iD += nFill;
-      }
-    }  // end of while, only one spoke per packet
-
     returns_per_line = qheader->scan_len;
     if (returns_per_line > RM_QUANTUM_SPOKE_LEN) {
       LOG_VERBOSE(wxT("Error returns_per_line too large %i"), returns_per_line);
       returns_per_line = RM_QUANTUM_SPOKE_LEN;
     }
+
+    // Only one spoke per packet, fully run-length coded
+    size_t src_len = wxMin((size_t)qheader->data_len, (size_t)(len - nextOffset));
+    RaymarineUnpackSpoke(RM_SPOKE_BYTES, data + nextOffset, src_len, src_len, unpacked_data, sizeof(unpacked_data),
+                         returns_per_line);
     dataPtr = unpacked_data;
     m_ri->m_statistics.spokes++;
     unsigned int spoke = qheader->azimuth;
@@ -1189,8 +1126,15 @@ void RaymarineReceive::ProcessQuantumScanData(const UINT8 *data, int len) {
       LOG_INFO(wxT("Error range invalid"));
       return;
     }
-    m_ri->ProcessRadarSpoke(angle, bearing, dataPtr, returns_per_line,
-                            m_range_meters * returns_per_line / qheader->returns_per_range / 2, nowMillis);
+    m_ri->QueueRadarSpoke(angle, bearing, dataPtr, returns_per_line,
+                          m_range_meters * returns_per_line / qheader->returns_per_range / 2, nowMillis);
+  }
+}
+
+// Called from ReplayReceive with a packet that was recorded in Entry().
+void RaymarineReceive::ReplayPacket(PacketChannel channel, const uint8_t *data, size_t len) {
+  if (channel == PACKET_DATA) {
+    ProcessFrame(data, len);
   }
 }
 
@@ -0,0 +1,205 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "RaymarineUnpack.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+// The decoding as it was done in RaymarineReceive::ProcessScanData before RaymarineUnpackSpoke, run on a
+// buffer that is large enough for anything a byte count can describe. Returns the number of valid bytes.
+static size_t UnpackReference(bool HDtype, const uint8_t *src, size_t data_len, size_t length, uint8_t *unpacked_data,
+                              size_t returns_per_line) {
+  uint8_t *dData = unpacked_data;
+  const uint8_t *sData = src;
+  unsigned int iS = 0;
+  unsigned int iD = 0;
+
+  while (iS < data_len) {
+    if (HDtype) {
+      if (iD >= returns_per_line) {
+        break;
+      }
+      if (*sData != 0x5c) {
+        *dData++ = *sData;
+        sData++;
+        iS++;
+        iD++;
+      } else {
+        uint8_t nFill = sData[1];
+        uint8_t cFill = sData[2];
+        for (unsigned int i = 0; i < nFill; i++) {
+          *dData++ = cFill;
+        }
+        sData += 3;
+        iS += 3;
+        iD += nFill;
+      }
+    } else {
+      if (*sData != 0x5c) {
+        *dData++ = (((*sData) & 0x0f) << 4) + 0x0f;
+        *dData++ = ((*sData) & 0xf0) + 0x0f;
+        sData++;
+        iS++;
+        iD += 2;
+      } else {
+        uint8_t nFill = sData[1];
+        uint8_t cFill = sData[2];
+        for (unsigned int i = 0; i < nFill; i++) {
+          *dData++ = ((cFill & 0x0f) << 4) + 0x0f;
+          *dData++ = (cFill & 0xf0) + 0x0f;
+        }
+        sData += 3;
+        iS += 3;
+        iD += nFill * 2;
+      }
+    }
+  }
+  if (iD != returns_per_line) {
+    while (iS < length && iD <= returns_per_line) {
+      if (HDtype) {
+        *dData++ = *sData;
+        sData++;
+        iS++;
+        iD++;
+      } else {
+        *dData++ = ((*sData) & 0x0f) << 4;
+        *dData++ = (*sData) & 0xf0;
+        sData++;
+        iS++;
+        iD += 2;
+      }
+    }
+  }
+  return iD;
+}
+
+static const size_t GUARD = 64;
+
+// Compare against the reference for well formed data, where the escapes do not run past the end
+static int Compare(bool hd, const vector<uint8_t> &src, size_t data_len, size_t returns) {
+  vector<uint8_t> expected(src.size() * 2 * 255 + 2 * returns + 16, 0xaa);
+  vector<uint8_t> actual(returns + GUARD, 0xaa);
+
+  size_t valid = UnpackReference(hd, &src[0], data_len, src.size(), &expected[0], returns);
+  size_t decoded = RaymarineUnpackSpoke(hd ? RM_SPOKE_BYTES : RM_SPOKE_NIBBLES, &src[0], data_len, src.size(), &actual[0],
+                                        returns, returns);
+  if (valid > returns) {
+    valid = returns;
+  }
+  if (decoded != valid) {
+    cout << "ERROR: " << (hd ? "HD" : "non-HD") << " decoded " << decoded << " returns, expected " << valid << "\n";
+    return 1;
+  }
+  for (size_t i = 0; i < returns + GUARD; i++) {
+    uint8_t want = (i < valid) ? expected[i] : (i < returns) ? 0 : 0xaa;
+    if (actual[i] != want) {
+      cout << "ERROR: " << (hd ? "HD" : "non-HD") << " len " << data_len << "/" << src.size() << " returns " << returns
+           << " differs at " << i << ": " << (int)actual[i] << " != " << (int)want << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Generate a random coded spoke of data_len bytes followed by tail_len raw bytes
+static vector<uint8_t> RandomSpoke(size_t data_len, size_t tail_len) {
+  vector<uint8_t> src;
+
+  while (src.size() < data_len) {
+    if (data_len - src.size() >= 3 && rand() % 4 == 0) {
+      src.push_back(RM_RLE_ESCAPE);
+      src.push_back((uint8_t)(rand() % 64));
+      src.push_back((uint8_t)rand());
+    } else {
+      uint8_t b = (uint8_t)rand();
+      src.push_back(b == RM_RLE_ESCAPE ? 0 : b);
+    }
+  }
+  for (size_t i = 0; i < tail_len; i++) {
+    src.push_back((uint8_t)rand());
+  }
+  return src;
+}
+
+// Malformed data must never make the decoder write outside dst
+static int Malformed(size_t dst_size) {
+  uint8_t src[300];
+  vector<uint8_t> dst(dst_size + GUARD, 0xaa);
+
+  for (size_t i = 0; i < sizeof(src); i++) {
+    src[i] = (i % 3 == 0) ? RM_RLE_ESCAPE : 0xff;  // maximum fill counts everywhere
+  }
+  for (int format = RM_SPOKE_NIBBLES; format <= RM_SPOKE_BYTES; format++) {
+    for (size_t len = 0; len <= sizeof(src); len++) {
+      RaymarineUnpackSpoke((RaymarineSpokeFormat)format, src, len + 1000, len, &dst[0], dst_size, 100000);
+      for (size_t i = dst_size; i < dst.size(); i++) {
+        if (dst[i] != 0xaa) {
+          cout << "ERROR: write beyond dst_size " << dst_size << " for len " << len << "\n";
+          return 1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+int RaymarineUnpackTest() {
+  int ret = 0;
+
+  srand(1);
+  for (int i = 0; i < 2000 && ret == 0; i++) {
+    size_t data_len = rand() % 600;
+    size_t tail_len = (i % 3 == 0) ? rand() % 600 : 0;
+    vector<uint8_t> src = RandomSpoke(data_len, tail_len);
+
+    if (src.empty()) {
+      continue;
+    }
+    ret |= Compare(false, src, data_len, 512);  // E120
+    ret |= Compare(true, src, data_len, 1024);  // E120 HD
+    ret |= Compare(true, src, data_len, 252);   // Quantum
+  }
+  ret |= Malformed(1024);
+  ret |= Malformed(251);
+
+  if (ret == 0) {
+    cout << "INFO: RaymarineUnpackSpoke matches the original decoder\n";
+  }
+  return ret;
+}
+
+PLUGIN_END_NAMESPACE
+
+int main() { return PLUGIN_NAMESPACE::RaymarineUnpackTest(); }
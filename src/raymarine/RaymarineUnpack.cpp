@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  Radar Plugin
+ * Author:   David Register
+ *           Dave Cowell
+ *           Kees Verruijt
+ *           Douwe Fokkema
+ *           Sean D'Epagnier
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register              bdbcat@yahoo.com *
+ *   Copyright (C) 2012-2013 by Dave Cowell                                *
+ *   Copyright (C) 2012-2016 by Kees Verruijt         canboat@verruijt.net *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************
+ */
+
+#include "RaymarineUnpack.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+// Inside the coded part the 4 bit returns are scaled to 0x0f..0xff, the raw tail is sent as 0x00..0xf0.
+#define NIBBLE_CODED_OFFSET (0x0f)
+#define NIBBLE_RAW_OFFSET (0x00)
+
+// Length of the literal run starting at src, i.e. up to the next escape or end.
+static inline size_t LiteralRun(const uint8_t *src, size_t len) {
+  const uint8_t *escape = (const uint8_t *)memchr(src, RM_RLE_ESCAPE, len);
+
+  return escape ? (size_t)(escape - src) : len;
+}
+
+// Expand packed nibbles into at most room bytes, returns the number written.
+static inline size_t ExpandNibbles(const uint8_t *src, size_t len, uint8_t *dst, size_t room, uint8_t offset) {
+  size_t pairs = wxMin(len, room / 2);
+
+  // Simple enough for the compiler to vectorize
+  for (size_t i = 0; i < pairs; i++) {
+    dst[2 * i] = ((src[i] & 0x0f) << 4) + offset;
+    dst[2 * i + 1] = (src[i] & 0xf0) + offset;
+  }
+  if (pairs < len && 2 * pairs < room) {
+    dst[2 * pairs] = ((src[pairs] & 0x0f) << 4) + offset;
+    return 2 * pairs + 1;
+  }
+  return 2 * pairs;
+}
+
+static inline void FillNibbles(uint8_t value, size_t n, uint8_t *dst) {
+  uint8_t low = ((value & 0x0f) << 4) + NIBBLE_CODED_OFFSET;
+  uint8_t high = (value & 0xf0) + NIBBLE_CODED_OFFSET;
+
+  if (low == high) {
+    memset(dst, low, n);
+    return;
+  }
+  for (size_t i = 0; i + 1 < n; i += 2) {
+    dst[i] = low;
+    dst[i + 1] = high;
+  }
+  if (n & 1) {
+    dst[n - 1] = low;
+  }
+}
+
+size_t RaymarineUnpackSpoke(RaymarineSpokeFormat format, const uint8_t *src, size_t rle_len, size_t src_len, uint8_t *dst,
+                            size_t dst_size, size_t returns) {
+  size_t scale = (format == RM_SPOKE_NIBBLES) ? 2 : 1;
+  size_t iS = 0;
+  size_t iD = 0;
+
+  if (returns > dst_size) {
+    returns = dst_size;
+  }
+  if (rle_len > src_len) {
+    rle_len = src_len;
+  }
+
+  // Anything beyond `returns` is not used, so decoding stops there
+  while (iS < rle_len && iD < returns) {
+    if (src[iS] != RM_RLE_ESCAPE) {
+      size_t run = LiteralRun(src + iS, rle_len - iS);
+
+      if (format == RM_SPOKE_NIBBLES) {
+        iD += ExpandNibbles(src + iS, run, dst + iD, returns - iD, NIBBLE_CODED_OFFSET);
+      } else {
+        run = wxMin(run, returns - iD);
+        memcpy(dst + iD, src + iS, run);
+        iD += run;
+      }
+      iS += run;
+    } else {
+      if (iS + 3 > src_len) {  // truncated escape sequence
+        break;
+      }
+      size_t n = wxMin(src[iS + 1] * scale, returns - iD);
+
+      if (format == RM_SPOKE_NIBBLES) {
+        FillNibbles(src[iS + 2], n, dst + iD);
+      } else {
+        memset(dst + iD, src[iS + 2], n);
+      }
+      iS += 3;
+      iD += n;
+    }
+  }
+
+  // Raw tail of partially coded spokes
+  if (iD < returns && iS < src_len) {
+    if (format == RM_SPOKE_NIBBLES) {
+      iD += ExpandNibbles(src + iS, src_len - iS, dst + iD, returns - iD, NIBBLE_RAW_OFFSET);
+    } else {
+      size_t run = wxMin(src_len - iS, returns - iD);
+      memcpy(dst + iD, src + iS, run);
+      iD += run;
+    }
+  }
+
+  if (iD < returns) {
+    memset(dst + iD, 0, returns - iD);
+  }
+  return iD;
+}
+
+PLUGIN_END_NAMESPACE
@@ -49,6 +49,10 @@ typedef __GLXextFuncPtr FunctionPointer;
 #include "shaderutil.inc"
 #undef SHADER_FUNCTION_LIST
 
+#define VERTEX_BUFFER_FUNCTION_LIST(proc, name) proc name;
+#include "shaderutil.inc"
+#undef VERTEX_BUFFER_FUNCTION_LIST
+
 PLUGIN_BEGIN_NAMESPACE
 
 GLboolean ShadersSupported(void) {
@@ -70,6 +74,28 @@ GLboolean ShadersSupported(void) {
   return ok;
 }
 
+GLboolean VertexBuffersSupported(void) {
+  static int supported = -1;  // only look them up once
+
+  if (supported < 0) {
+    supported = 1;
+#define VERTEX_BUFFER_FUNCTION_LIST(proc, name) \
+  {                                             \
+    union {                                     \
+      proc f;                                   \
+      FunctionPointer p;                        \
+    } u;                                        \
+    u.p = SET_FUNCTION_POINTER("gl" #name);     \
+    if (!u.p) supported = 0;                    \
+    name = u.f;                                 \
+  }
+#include "shaderutil.inc"
+#undef VERTEX_BUFFER_FUNCTION_LIST
+  }
+
+  return (GLboolean)supported;
+}
+
 bool CompileShaderText(GLuint *shader, GLenum shaderType, const char *text) {
   GLint stat;
 